@@ -1,7 +1,7 @@
 #include "circle.hpp"
 #include "cube.hpp"
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
+#include "fixed.hpp"
+#include "raster.hpp"
 #include "utils.hpp"
 #include <math.h>
 
@@ -10,6 +10,9 @@ namespace circle_animation {
 using namespace utils;
 using namespace cube;
 
+// 2.5 rad/s in binary angle units (65536 per turn)
+#define SPIN_ANGLE_PER_S 26076
+
 // Simple HSV→RGB helper (H in [0,1), S,V in [0,1])
 static rgb_t hsv_to_rgb(float h, float s, float v) {
     if (s <= 0.0f) {
@@ -61,87 +64,41 @@ static rgb_t hsv_to_rgb(float h, float s, float v) {
 }
 
 // Draw a filled circle in the XY plane, spinning around Y so it sweeps along Z.
-void CircleSpinAnim::init(Cube &cube) {
+void CircleSpinAnim::init(Frame &target) {
     frame_ = 0;
-    ESP_ERROR_CHECK(cube.clear());
+    elapsed_ms_ = 0;
+    target.clear();
 }
 
-void CircleSpinAnim::step(Cube &cube) {
-    const uint32_t faces = cube.total_faces();
-    if (faces == 0) {
-        vTaskDelay(pdMS_TO_TICKS(50));
-        return;
-    }
+void CircleSpinAnim::step(Frame &target, uint32_t dt_ms) {
+    const uint32_t faces = target.depth();
+    if (faces == 0) return;
+    elapsed_ms_ += dt_ms;
 
     // 1) Soft global fade toward black (like rain), no hard clears -> no flicker
     const uint8_t fade_fp = 230; // 0..255, closer to 255 => slower fade
-    for (uint32_t z = 0; z < faces; ++z) {
-        for (uint32_t y = 0; y < K_MAX_HEIGHT; ++y) {
-            for (uint32_t x = 0; x < K_MAX_WIDTH; ++x) {
-                rgb_t c = cube(x, y, z);
-                c.r = static_cast<uint8_t>((c.r * fade_fp) / 255);
-                c.g = static_cast<uint8_t>((c.g * fade_fp) / 255);
-                c.b = static_cast<uint8_t>((c.b * fade_fp) / 255);
-                cube(x, y, z) = c;
-            }
-        }
-    }
+    target.fade(fade_fp);
 
-    // 2) Geometry: cube center
-    const float cx = (K_MAX_WIDTH - 1) * 0.5f;
-    const float cy = (K_MAX_HEIGHT - 1) * 0.5f;
-    const float cz = (faces - 1) * 0.5f;
+    // 2) Geometry: cube center, in Q16 voxels
+    const uint32_t W = target.width();
+    const uint32_t H = target.height();
+    const fx::vec3 center{fx::from_int(W - 1) / 2, fx::from_int(H - 1) / 2, fx::from_int(faces - 1) / 2};
 
-    // Circle radius in XY; circumference ≈ 9 => r ≈ 9 / (2π) ≈ 1.43.
-    // Use that directly (it will still look nice on the 8×8 grid).
-    const float radius = 3.5f;
-    const float radius2 = radius * radius;
+    // Circle radius in XY: 3.5 on the 8×8 grid, scaled with the smaller face side.
+    const fx::q16 radius = fx::from_int(W < H ? W : H) * 7 / 16;
 
-    // 3) Animation parameters: spin around Y, color cycle
-    const float spin_speed = 0.15f; // faster rotation
-    const float hue_speed = 0.01f;
-
-    float angle = frame_ * spin_speed;
-    float hue = fmodf(frame_ * hue_speed, 1.0f);
+    // 3) Animation parameters: spin around Y at 2.5 rad/s, hue cycle once every 6 s
+    const uint16_t angle = static_cast<uint16_t>((uint64_t)elapsed_ms_ * SPIN_ANGLE_PER_S / 1000);
+    const float hue = static_cast<float>(elapsed_ms_ % 6000) / 6000.0f;
     rgb_t color = hsv_to_rgb(hue, 1.0f, 1.0f);
 
-    // Rotation around Y: we rotate the *points* backwards so the disc effectively spins forward.
-    float cosA = cosf(-angle);
-    float sinA = sinf(-angle);
-
-    // 4) For each voxel, test membership in the spinning disc
-    // Base disc: XY plane, centered at (cx,cy), lying at z'=0 in rotated coordinates.
-    // Condition: |z'| small and x'^2 + y'^2 <= radius^2.
-    const float plane_thickness = 0.6f; // how "thick" the disc is along its normal
-
-    for (uint32_t z = 0; z < faces; ++z) {
-        for (uint32_t y = 0; y < K_MAX_HEIGHT; ++y) {
-            for (uint32_t x = 0; x < K_MAX_WIDTH; ++x) {
-                // Centered coordinates
-                float dx = static_cast<float>(x) - cx;
-                float dy = static_cast<float>(y) - cy;
-                float dz = static_cast<float>(z) - cz;
-
-                // Rotate around Y by -angle
-                float xr = dx * cosA + dz * sinA;
-                float yr = dy;
-                float zr = -dx * sinA + dz * cosA;
-
-                // Check if point lies near the z'=0 plane (the disc plane)
-                if (fabsf(zr) > plane_thickness) continue;
-
-                // Check if within circle in XY
-                float dist2 = xr * xr + yr * yr;
-                if (dist2 > radius2) continue;
-
-                cube(x, y, z) = color;
-            }
-        }
-    }
+    // 4) The disc lies in the XY plane rotated around Y, so its normal is (sin, 0, cos).
+    // The rasteriser only visits the voxels in the disc's bounding box.
+    const fx::vec3 normal{fx::sin(angle), 0, fx::cos(angle)};
+    const fx::q16 plane_thickness = fx::to_q16(0.6f); // how "thick" the disc is along its normal
+    raster::disc(target, center, normal, radius, plane_thickness, color);
 
-    ESP_ERROR_CHECK(cube.show());
     ++frame_;
-    vTaskDelay(pdMS_TO_TICKS(60));
 }
 
 } // namespace circle_animation
@@ -1,8 +1,8 @@
 #include "countdown.hpp"
 #include "cube.hpp"
-#include "esp_random.h"
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
+#include "blit.hpp"
+#include "fixed.hpp"
+#include "raster.hpp"
 #include "utils.hpp"
 #include <math.h>
 
@@ -34,36 +34,29 @@ static const uint8_t DIGIT_FONT[10][8] = {
     {0b00111100, 0b01100110, 0b01100110, 0b00111110, 0b00000110, 0b01100110, 0b00111100, 0b00000000},
 };
 
-static void draw_digit_on_face(cube::Cube &cube, int digit, uint32_t face, rgb_t base_color, float brightness_factor) {
+// brightness: 0..255 multiplier applied to base_color.
+// The whole face is redrawn (clear glyph bits in black); the 8x8 glyph is scaled by the
+// largest whole factor that fits the face and centred on it.
+static void draw_digit_on_face(cube::Frame &frame, int digit, uint32_t face, rgb_t base_color, uint8_t brightness) {
     if (digit < 0 || digit > 9) return;
-    if (face >= cube.total_faces()) return;
-    if (brightness_factor < 0.0f) brightness_factor = 0.0f;
-    if (brightness_factor > 1.0f) brightness_factor = 1.0f;
-
-    uint8_t r = static_cast<uint8_t>(base_color.r * brightness_factor);
-    uint8_t g = static_cast<uint8_t>(base_color.g * brightness_factor);
-    uint8_t b = static_cast<uint8_t>(base_color.b * brightness_factor);
-    rgb_t color{r, g, b};
-
-    for (uint32_t y = 0; y < K_MAX_HEIGHT; ++y) {
-        // flip Y so font row 0 is at the bottom of the cube
-        uint32_t fy = K_MAX_HEIGHT - 1 - y;
-        uint8_t row = DIGIT_FONT[digit][fy];
-        for (uint32_t x = 0; x < K_MAX_WIDTH; ++x) {
-            bool on = (row & (1u << (7 - x))) != 0;
-            cube(x, y, face) = on ? color : rgb_t{0, 0, 0};
-        }
-    }
+    if (face >= frame.depth()) return;
+
+    const rgb_t color = scale(base_color, brightness);
+    const rgb_t black{0, 0, 0};
+    const uint32_t side = frame.width() < frame.height() ? frame.width() : frame.height();
+    const uint32_t s = side >= 8 ? side / 8 : 1;
+    if (frame.width() != 8 * s || frame.height() != 8 * s) frame.fill_layer(face, black);
+    raster::blit_mask8(frame, raster::face_plane(frame, face), DIGIT_FONT[digit], 8,
+                       (int32_t)(frame.width() - 8 * s) / 2, (int32_t)(frame.height() - 8 * s) / 2, color, &black, s);
 }
 
-// Simple radial explosion from cube center.
+// Simple radial explosion shell around the cube center; the sparks are particles (emit_sparks).
 // radius: 0..max_radius, color fades over time via multiplier (0..255).
-static void draw_explosion_frame(cube::Cube &cube, float radius, uint8_t brightness, float t01) {
-    const float cx = (K_MAX_WIDTH - 1) * 0.5f;
-    const float cy = (K_MAX_HEIGHT - 1) * 0.5f;
-    const float cz = (cube.total_faces() - 1) * 0.5f;
+static void draw_explosion_frame(cube::Frame &frame, float radius, uint8_t brightness, float t01) {
+    const fx::vec3 center{fx::from_int(frame.width() - 1) / 2, fx::from_int(frame.height() - 1) / 2,
+                          fx::from_int(frame.depth() - 1) / 2};
     const float r2 = radius * radius;
-    const float band = 1.0f; // thickness of the main explosion shell
+    const float band = 1.0f; // thickness of the main explosion shell, on the squared distance
 
     // Color over time: start bluish, go through green, end more reddish.
     float phase = t01;
@@ -71,112 +64,71 @@ static void draw_explosion_frame(cube::Cube &cube, float radius, uint8_t brightn
     uint8_t base_g = (uint8_t)(255.0f * (1.0f - fabsf(phase - 0.5f) * 2.0f)); // peak green at mid
     uint8_t base_b = (uint8_t)(255.0f * (1.0f - phase));
 
-    // 1) Main symmetric shell
-    for (uint32_t z = 0; z < cube.total_faces(); ++z) {
-        for (uint32_t y = 0; y < K_MAX_HEIGHT; ++y) {
-            for (uint32_t x = 0; x < K_MAX_WIDTH; ++x) {
-                float dx = (float)x - cx;
-                float dy = (float)y - cy;
-                float dz = (float)z - cz;
-                float d2 = dx * dx + dy * dy + dz * dz;
-
-                bool in_shell = (d2 >= (r2 - band) && d2 <= (r2 + band));
-                if (in_shell) {
-                    uint8_t r = (uint8_t)((base_r * brightness) / 255u);
-                    uint8_t g = (uint8_t)((base_g * brightness) / 255u);
-                    uint8_t b = (uint8_t)((base_b * brightness) / 255u);
-                    cube(x, y, z) = rgb_t{r, g, b};
-                } else {
-                    cube(x, y, z) = rgb_t{0, 0, 0};
-                }
-            }
-        }
-    }
-
-    // 2) Stronger spark clusters around the shell, more obvious than before
-    const int spark_count = 30;           // more sparks
-    const float spark_band = band * 2.5f; // allow a bit more spread
-
-    for (int i = 0; i < spark_count; ++i) {
-        uint32_t x = esp_random() % K_MAX_WIDTH;
-        uint32_t y = esp_random() % K_MAX_HEIGHT;
-        uint32_t z = esp_random() % cube.total_faces();
-
-        float dx = (float)x - cx;
-        float dy = (float)y - cy;
-        float dz = (float)z - cz;
-        float d2 = dx * dx + dy * dy + dz * dz;
-
-        // Only keep sparks reasonably near the target radius
-        if (d2 < (r2 - spark_band) || d2 > (r2 + spark_band)) continue;
-
-        // Much brighter/whiter than the shell so it clearly pops
-        uint8_t r = (uint8_t)std::min<int>(base_r + 120, 255);
-        uint8_t g = (uint8_t)std::min<int>(base_g + 120, 255);
-        uint8_t b = (uint8_t)std::min<int>(base_b + 120, 255);
-
-        r = (uint8_t)((r * brightness) / 255u);
-        g = (uint8_t)((g * brightness) / 255u);
-        b = (uint8_t)((b * brightness) / 255u);
-
-        cube(x, y, z) = rgb_t{r, g, b};
-    }
-
-    // 3) A few coarse "rays" shooting outwards (fireworks-like streaks)
-    const int ray_count = 6;
-    for (int i = 0; i < ray_count; ++i) {
-        // Random direction vector from center, normalized-ish
-        int sx = (int)(esp_random() % K_MAX_WIDTH);
-        int sy = (int)(esp_random() % K_MAX_HEIGHT);
-        int sz = (int)(esp_random() % cube.total_faces());
-
-        float dx = (float)sx - cx;
-        float dy = (float)sy - cy;
-        float dz = (float)sz - cz;
-        float len = sqrtf(dx * dx + dy * dy + dz * dz);
-        if (len < 0.001f) continue;
-        dx /= len;
-        dy /= len;
-        dz /= len;
-
-        // Ray length proportional to current radius, but short
-        float ray_len = radius * 0.7f;
-        int steps = (int)ray_len;
-
-        for (int s = 0; s < steps; ++s) {
-            float t = (float)s / (float)steps;
-            int rx = (int)roundf(cx + dx * (radius * t));
-            int ry = (int)roundf(cy + dy * (radius * t));
-            int rz = (int)roundf(cz + dz * (radius * t));
-
-            if (rx < 0 || ry < 0 || rz < 0) continue;
-            if (rx >= (int)K_MAX_WIDTH || ry >= (int)K_MAX_HEIGHT || rz >= (int)cube.total_faces()) continue;
-
-            // Fade along the ray and with overall brightness
-            float ray_brightness = (1.0f - t) * (brightness / 255.0f);
-            uint8_t r = (uint8_t)(std::min<int>(base_r + 80, 255) * ray_brightness);
-            uint8_t g = (uint8_t)(std::min<int>(base_g + 80, 255) * ray_brightness);
-            uint8_t b = (uint8_t)(std::min<int>(base_b + 80, 255) * ray_brightness);
+    // Main symmetric shell (r2 - band <= d2 <= r2 + band), on a black background
+    frame.fill(rgb_t{0, 0, 0});
+    const rgb_t shell{(uint8_t)((base_r * brightness) / 255u), (uint8_t)((base_g * brightness) / 255u),
+                      (uint8_t)((base_b * brightness) / 255u)};
+    const fx::q16 r_inner = r2 > band ? fx::sqrt(fx::to_q16(r2 - band)) : 0;
+    const fx::q16 r_outer = fx::sqrt(fx::to_q16(r2 + band));
+    raster::sphere_shell(frame, center, r_inner, r_outer, shell);
+}
 
-            cube((uint32_t)rx, (uint32_t)ry, (uint32_t)rz) = rgb_t{r, g, b};
-        }
+// Burst of bright sparks from the cube centre, fast enough to reach the shell's final radius
+// as they burn out.
+void CountdownAnim::emit_sparks(const Frame &frame, float max_radius) {
+    const float cx = frame.width() * 0.5f;
+    const float cy = frame.height() * 0.5f;
+    const float cz = frame.depth() * 0.5f;
+    const float speed = max_radius * 1000.0f / 1200.0f; // voxels per second
+
+    sparks_.clear();
+    for (uint16_t i = 0; i < MAX_SPARKS; ++i) {
+        // Random direction: rejection-sample the unit ball
+        float dx, dy, dz, len2;
+        do {
+            dx = (float)rng_.below(2001) / 1000.0f - 1.0f;
+            dy = (float)rng_.below(2001) / 1000.0f - 1.0f;
+            dz = (float)rng_.below(2001) / 1000.0f - 1.0f;
+            len2 = dx * dx + dy * dy + dz * dz;
+        } while (len2 > 1.0f || len2 < 0.01f);
+        const float v = speed * (0.7f + (float)rng_.below(600) / 1000.0f) / sqrtf(len2);
+
+        particles::Emit e{};
+        e.x = particles::to_fx(cx);
+        e.y = particles::to_fx(cy);
+        e.z = particles::to_fx(cz);
+        e.vx = particles::to_fx(dx * v);
+        e.vy = particles::to_fx(dy * v);
+        e.vz = particles::to_fx(dz * v);
+        e.life_ms = static_cast<uint16_t>(rng_.range(700, 1199));
+        // Much brighter/whiter than the shell so they clearly pop
+        e.color = rgb_t{(uint8_t)rng_.range(120, 219), (uint8_t)rng_.range(120, 219), 255};
+        sparks_.spawn(e);
     }
 }
 
-void CountdownAnim::init(Cube &cube) {
+void CountdownAnim::init(Frame &target) {
     current_digit_ = 9;
     frames_left_ = 0;
     phase_ = Phase::DigitFly;
     z_pos_ = 0;
     explosion_step_ = 0;
+    if (sparks_.capacity() == 0) {
+        sparks_.reserve(MAX_SPARKS);
+        sparks_.set_gravity(0, -particles::to_fx(3.0f), 0);
+        sparks_.set_fade_with_age(true);
+        sparks_.set_blend(particles::Blend::Add);
+    }
+    sparks_.clear();
+    rng_.seed(rng_seed());
     // clear trail history
     for (uint32_t i = 0; i < MAX_TRAIL_LEN; ++i) {
         trail_z_[i] = -1;
     }
-    ESP_ERROR_CHECK(cube.clear());
+    target.clear();
 }
 
-void CountdownAnim::step(Cube &cube) {
+void CountdownAnim::step(Frame &target, uint32_t dt_ms) {
     switch (phase_) {
     case Phase::DigitFly: {
         // Limit effective trail to at most 2 layers (0 = current, 1 = previous)
@@ -184,7 +136,7 @@ void CountdownAnim::step(Cube &cube) {
 
         // 1) Soft fade only on trail layers, and hard-clear others to remove old digits.
         const uint8_t fade_fp = 220; // 0..255
-        const uint32_t faces = cube.total_faces();
+        const uint32_t faces = target.depth();
 
         // Compute the set of z layers that will hold the trail this frame:
         // z_pos_ (current) and optionally z_pos_-1 (previous).
@@ -197,20 +149,12 @@ void CountdownAnim::step(Cube &cube) {
         }
 
         for (uint32_t z = 0; z < faces; ++z) {
-            for (uint32_t y = 0; y < K_MAX_HEIGHT; ++y) {
-                for (uint32_t x = 0; x < K_MAX_WIDTH; ++x) {
-                    if (is_trail_layer[z]) {
-                        // fade on trail layers
-                        rgb_t c = cube(x, y, z);
-                        c.r = static_cast<uint8_t>((c.r * fade_fp) / 255);
-                        c.g = static_cast<uint8_t>((c.g * fade_fp) / 255);
-                        c.b = static_cast<uint8_t>((c.b * fade_fp) / 255);
-                        cube(x, y, z) = c;
-                    } else {
-                        // hard clear on non-trail layers to avoid old digits overlapping
-                        cube(x, y, z) = rgb_t{0, 0, 0};
-                    }
-                }
+            if (is_trail_layer[z]) {
+                // fade on trail layers
+                target.fade_layer(z, fade_fp);
+            } else {
+                // hard clear on non-trail layers to avoid old digits overlapping
+                target.fill_layer(z, rgb_t{0, 0, 0});
             }
         }
 
@@ -231,14 +175,12 @@ void CountdownAnim::step(Cube &cube) {
             if (static_cast<uint32_t>(z) >= faces) continue;
 
             // Brightness: current layer full, previous dimmer
-            float brightness = (i == 0) ? 1.0f : 0.5f;
-            draw_digit_on_face(cube, current_digit_, static_cast<uint32_t>(z), base_color, brightness);
+            const uint8_t brightness = (i == 0) ? 255 : 128;
+            draw_digit_on_face(target, current_digit_, static_cast<uint32_t>(z), base_color, brightness);
         }
 
-        ESP_ERROR_CHECK(cube.show());
-
         // 4) Advance along Z until we hit the last face
-        if (z_pos_ + 1 < cube.total_faces()) {
+        if (z_pos_ + 1 < target.depth()) {
             ++z_pos_;
         } else {
             // Finished this digit's fly-through; prep next digit
@@ -256,7 +198,6 @@ void CountdownAnim::step(Cube &cube) {
             }
         }
 
-        vTaskDelay(pdMS_TO_TICKS(80));
         break;
     }
 
@@ -264,14 +205,16 @@ void CountdownAnim::step(Cube &cube) {
         // Only the spherical explosion now (no full-cube white flash)
         const int total_steps = 20;
         float t = (float)explosion_step_ / (float)total_steps;
-        float max_radius = sqrtf((K_MAX_WIDTH - 1) * (K_MAX_WIDTH - 1) + (K_MAX_HEIGHT - 1) * (K_MAX_HEIGHT - 1) +
-                                 (cube.total_faces() - 1) * (cube.total_faces() - 1)) /
-                           2.0f;
+        const float w1 = target.width() - 1.0f;
+        const float h1 = target.height() - 1.0f;
+        const float d1 = target.depth() - 1.0f;
+        float max_radius = sqrtf(w1 * w1 + h1 * h1 + d1 * d1) / 2.0f;
         float radius = t * max_radius;
         uint8_t brightness = (uint8_t)((1.0f - t) * 255.0f);
 
-        draw_explosion_frame(cube, radius, brightness, t);
-        ESP_ERROR_CHECK(cube.show());
+        if (explosion_step_ == 0) emit_sparks(target, max_radius);
+        draw_explosion_frame(target, radius, brightness, t);
+        sparks_.step(target, dt_ms);
 
         if (explosion_step_ >= (uint32_t)total_steps) {
             // End of explosion: restart countdown from 9
@@ -285,8 +228,6 @@ void CountdownAnim::step(Cube &cube) {
         } else {
             ++explosion_step_;
         }
-
-        vTaskDelay(pdMS_TO_TICKS(60));
         break;
     }
     }
@@ -8,11 +8,13 @@ using namespace anim_common;
 
 class CircleSpinAnim : public IAnimation {
   public:
-    void init(Cube &cube) override;
-    void step(Cube &cube) override;
+    void init(Frame &target) override;
+    void step(Frame &target, uint32_t dt_ms) override;
+    const char *name() const override { return "circle_spin"; }
 
   private:
     uint32_t frame_ = 0;
+    uint32_t elapsed_ms_ = 0; // drives spin and hue so speed does not depend on frame rate
 };
 
 } // namespace circle_animation
@@ -7,14 +7,33 @@
 namespace anim_common {
 
 using cube::Cube;
+using cube::Frame;
 using utils::rgb_t;
 
 // ------------------- Core animation interface -------------------
 
+// Default frame period for animations that do not ask for a specific rate
+#define K_DEFAULT_FRAME_MS 60
+
+// Animations render into a target Frame with the cube's geometry: the cube's back buffer
+// when one plays on its own, or an off-screen layer when several are composited. The
+// target is the same frame on every call until the next init(), so animations may build
+// on what they drew last (fading trails and the like).
+// init() resets the animation and clears the target; nothing is shown until the caller
+// presents the frame. step() renders one frame and returns; the render scheduler owns
+// pacing and calls cube.show() afterwards. dt_ms is the wall time since the previous
+// step() (0 on the first frame after init()).
 struct IAnimation {
     virtual ~IAnimation() = default;
-    virtual void init(Cube &cube) = 0;
-    virtual void step(Cube &cube) = 0;
+    virtual void init(Frame &target) = 0;
+    virtual void step(Frame &target, uint32_t dt_ms) = 0;
+    // Desired time between frames; queried every frame so it may change with the animation's phase.
+    virtual uint32_t frame_period_ms() const { return K_DEFAULT_FRAME_MS; }
+    // Called after show() has handed the frame to the strips, while it transmits. Animations
+    // that stream their frames from slow memory can warm the cache for the next step() here.
+    virtual void prefetch() {}
+    // Short identifier for logs, timing dumps and benchmarks
+    virtual const char *name() const = 0;
 };
 
 // Common base state info (frame counter, etc.)
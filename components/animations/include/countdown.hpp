@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common.hpp"
+#include "particles.hpp"
 
 namespace countdown_animation {
 
@@ -8,13 +9,18 @@ using namespace anim_common;
 
 class CountdownAnim : public IAnimation {
   public:
-    void init(Cube &cube) override;
-    void step(Cube &cube) override;
+    void init(Frame &target) override;
+    void step(Frame &target, uint32_t dt_ms) override;
+    const char *name() const override { return "countdown"; }
+    uint32_t frame_period_ms() const override { return phase_ == Phase::DigitFly ? 80 : 60; }
 
   private:
     enum class Phase : uint8_t { DigitFly, Explosion };
 
     static constexpr uint32_t MAX_TRAIL_LEN = 6;
+    static constexpr uint16_t MAX_SPARKS = 64;
+
+    void emit_sparks(const Frame &frame, float max_radius);
 
     int current_digit_ = 9;
     uint32_t frames_left_ = 0; // kept for future tweaks
@@ -24,6 +30,9 @@ class CountdownAnim : public IAnimation {
 
     // Z positions for trailing layers; index 0 = newest (brightest), up to MAX_TRAIL_LEN-1 = oldest (dimmest)
     int32_t trail_z_[MAX_TRAIL_LEN] = {-1, -1, -1, -1, -1, -1};
+    // Sparks thrown out by the explosion, emitted once when it starts
+    particles::ParticleSystem sparks_;
+    utils::Rng rng_;
 };
 
 } // namespace countdown_animation
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common.hpp"
+#include "particles.hpp"
 #include <stddef.h>
 #include <stdint.h>
 
@@ -10,15 +11,9 @@ using namespace anim_common;
 
 // ------------------- Rain primitive state & functions -------------------
 struct RainState : public BaseAnimState {
-    struct Droplet {
-        int x, y, z;
-        rgb_t color;
-        bool active;
-    };
-
-    static constexpr int MAX_DROPLETS = 256;
-
-    Droplet drops[MAX_DROPLETS];
+    // Droplets fall along -y and die below the bottom layer; the pool holds half the cube
+    particles::ParticleSystem drops;
+    utils::Rng rng;
     int W; // width
     int H; // height
     int D; // depth (faces)
@@ -29,15 +24,17 @@ struct RainState : public BaseAnimState {
 };
 
 // Low-level, reusable building blocks
-void rain_init(RainState &state, Cube &cube, float density, int fall_speed_ms, float trail_strength);
-void rain_step(RainState &state, Cube &cube);
+void rain_init(RainState &state, Frame &frame, float density, int fall_speed_ms, float trail_strength);
+void rain_step(RainState &state, Frame &frame, uint32_t dt_ms);
 
 // ------------------- High-level animations -------------------
 
 class LightRainAnim : public IAnimation {
   public:
-    void init(Cube &cube) override;
-    void step(Cube &cube) override;
+    void init(Frame &target) override;
+    void step(Frame &target, uint32_t dt_ms) override;
+    uint32_t frame_period_ms() const override { return state_.fall_speed_ms; }
+    const char *name() const override { return "light_rain"; }
 
   private:
     RainState state_{};
@@ -45,8 +42,10 @@ class LightRainAnim : public IAnimation {
 
 class HeavyRainAnim : public IAnimation {
   public:
-    void init(Cube &cube) override;
-    void step(Cube &cube) override;
+    void init(Frame &target) override;
+    void step(Frame &target, uint32_t dt_ms) override;
+    uint32_t frame_period_ms() const override { return state_.fall_speed_ms; }
+    const char *name() const override { return "heavy_rain"; }
 
   private:
     RainState state_{};
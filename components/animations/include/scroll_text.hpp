@@ -0,0 +1,30 @@
+#pragma once
+
+#include "common.hpp"
+
+namespace scroll_text_animation {
+
+using namespace anim_common;
+
+// Marquee: `text` scrolls around the four side walls of the cube, one continuous band
+// running front -> right -> back -> left, vertically centred.
+class ScrollTextAnim : public IAnimation {
+  public:
+    explicit ScrollTextAnim(const char *text = "AURORABOX", rgb_t color = rgb_t{255, 120, 0},
+                            uint32_t columns_per_s = 10)
+        : text_(text), color_(color), columns_per_s_(columns_per_s) {}
+
+    void init(Frame &target) override;
+    void step(Frame &target, uint32_t dt_ms) override;
+    const char *name() const override { return "scroll_text"; }
+
+    void set_text(const char *text) { text_ = text; }
+
+  private:
+    const char *text_;
+    rgb_t color_;
+    uint32_t columns_per_s_;
+    uint32_t elapsed_ms_ = 0; // since the text last entered the band
+};
+
+} // namespace scroll_text_animation
@@ -1,7 +1,4 @@
 #include "rain.hpp"
-#include "esp_random.h"
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
 #include "utils.hpp"
 
 namespace rain_animation {
@@ -9,10 +6,10 @@ namespace rain_animation {
 using namespace utils;
 
 // Initialize rain animation state
-void rain_init(RainState &state, cube::Cube &cube, float density, int fall_speed_ms, float trail_strength) {
-    state.W = K_MAX_WIDTH;
-    state.H = K_MAX_HEIGHT;
-    state.D = cube.total_faces();
+void rain_init(RainState &state, cube::Frame &frame, float density, int fall_speed_ms, float trail_strength) {
+    state.W = frame.width();
+    state.H = frame.height();
+    state.D = frame.depth();
 
     // clamp params a bit
     if (density < 0.0f) density = 0.0f;
@@ -26,99 +23,70 @@ void rain_init(RainState &state, cube::Cube &cube, float density, int fall_speed
     state.trail_strength = trail_strength;
     state.trail_fp = static_cast<uint8_t>(trail_strength * 255.0f);
 
-    // reset droplets
-    for (int i = 0; i < RainState::MAX_DROPLETS; ++i) {
-        state.drops[i].active = false;
-    }
+    // reset droplets; the pool is sized once per geometry
+    uint32_t pool = (uint32_t)state.W * state.H * state.D / 2;
+    if (pool > 0xFFFF) pool = 0xFFFF;
+    if (state.drops.capacity() != pool) state.drops.reserve(pool);
+    state.drops.clear();
+    state.drops.set_bounds(state.W, state.H, state.D);
+    state.rng.seed(rng_seed());
 
-    ESP_ERROR_CHECK(cube.clear());
-    vTaskDelay(pdMS_TO_TICKS(50));
+    frame.clear();
 }
 
 // Perform one frame / step of the rain animation
-void rain_step(RainState &state, cube::Cube &cube) {
+void rain_step(RainState &state, cube::Frame &frame, uint32_t dt_ms) {
     const int W = state.W;
     const int H = state.H;
     const int D = state.D;
-    const uint8_t trail_fp = state.trail_fp;
 
     // 1) Fade toward black for soft trails
-    for (int x = 0; x < W; ++x) {
-        for (int y = 0; y < H; ++y) {
-            for (int z = 0; z < D; ++z) {
-                rgb_t c = cube(x, y, z);
-                c.r = (uint8_t)((c.r * trail_fp) / 255);
-                c.g = (uint8_t)((c.g * trail_fp) / 255);
-                c.b = (uint8_t)((c.b * trail_fp) / 255);
-                cube(x, y, z) = c;
-            }
-        }
-    }
-
-    // 2) Move droplets down along -y; deactivate when y < 0
-    for (int i = 0; i < RainState::MAX_DROPLETS; ++i) {
-        auto &drop = state.drops[i];
-        if (!drop.active) continue;
+    frame.fade(state.trail_fp);
 
-        drop.y -= 1; // fall one step
-
-        if (drop.y < 0) {
-            drop.active = false;
-            continue;
-        }
-
-        if (drop.y >= 0 && drop.y < H && drop.x >= 0 && drop.x < W && drop.z >= 0 && drop.z < D) {
-            cube(drop.x, drop.y, drop.z) = drop.color;
-        }
-    }
+    // 2) Move droplets down along -y; they die once they leave the cube
+    state.drops.update(dt_ms);
 
     // 3) Spawn new droplets at the top layer y = H-1
     float exact_spawn = state.density * (float)(W * D) * 0.5f;
     int spawn_count = (int)exact_spawn;
-    if ((esp_random() % 1000) < (uint32_t)((exact_spawn - spawn_count) * 1000.0f)) {
+    if (state.rng.chance((uint32_t)((exact_spawn - spawn_count) * 1000.0f), 1000)) {
         spawn_count++;
     }
 
+    const int32_t fall_v = -(K_PARTICLE_ONE * 1000) / state.fall_speed_ms; // one voxel per fall_speed_ms
     for (int k = 0; k < spawn_count; ++k) {
-        for (int i = 0; i < RainState::MAX_DROPLETS; ++i) {
-            auto &drop = state.drops[i];
-            if (!drop.active) {
-                drop.active = true;
-                drop.x = esp_random() % W;
-                drop.y = H - 1;
-                drop.z = esp_random() % D;
-                drop.color = random_color();
-
-                if (drop.z < D) {
-                    cube(drop.x, drop.y, drop.z) = drop.color;
-                }
-                break;
-            }
-        }
+        particles::Emit e{};
+        e.x = particles::voxel_fx(state.rng.below(W));
+        e.y = particles::voxel_fx(H - 1);
+        e.z = particles::voxel_fx(state.rng.below(D));
+        e.vy = fall_v;
+        e.life_ms = K_PARTICLE_IMMORTAL;
+        e.color = random_color(state.rng);
+        if (!state.drops.spawn(e)) break; // pool full
     }
 
-    ESP_ERROR_CHECK(cube.show());
-    vTaskDelay(pdMS_TO_TICKS(state.fall_speed_ms));
+    // 4) Draw every droplet in one pass
+    state.drops.render(frame);
 }
 
-void LightRainAnim::init(Cube &cube) {
-    rain_init(state_, cube,
+void LightRainAnim::init(Frame &target) {
+    rain_init(state_, target,
               0.04f, // density
               60,    // fall speed
               0.55f  // trail strength
     );
 }
 
-void LightRainAnim::step(Cube &cube) { rain_step(state_, cube); }
+void LightRainAnim::step(Frame &target, uint32_t dt_ms) { rain_step(state_, target, dt_ms); }
 
-void HeavyRainAnim::init(Cube &cube) {
-    rain_init(state_, cube,
+void HeavyRainAnim::init(Frame &target) {
+    rain_init(state_, target,
               0.9f, // density
               60,   // fall speed
               0.55f // trail strength
     );
 }
 
-void HeavyRainAnim::step(Cube &cube) { rain_step(state_, cube); }
+void HeavyRainAnim::step(Frame &target, uint32_t dt_ms) { rain_step(state_, target, dt_ms); }
 
 } // namespace rain_animation
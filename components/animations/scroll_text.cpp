@@ -0,0 +1,42 @@
+#include "scroll_text.hpp"
+#include "font.hpp"
+
+namespace scroll_text_animation {
+
+void ScrollTextAnim::init(Frame &target) {
+    elapsed_ms_ = 0;
+    target.clear();
+}
+
+void ScrollTextAnim::step(Frame &target, uint32_t dt_ms) {
+    const int32_t W = target.width();
+    const int32_t H = target.height();
+    const int32_t D = target.depth();
+    elapsed_ms_ += dt_ms;
+
+    // The band: each wall starts at the corner where the previous one ends, rows top down
+    const int32_t top = H - 1;
+    const raster::Plane walls[4] = {
+        {{0, top, 0}, {1, 0, 0}, {0, -1, 0}},          // front, z = 0
+        {{W - 1, top, 0}, {0, 0, 1}, {0, -1, 0}},      // right, x = W - 1
+        {{W - 1, top, D - 1}, {-1, 0, 0}, {0, -1, 0}}, // back, z = D - 1
+        {{0, top, D - 1}, {0, 0, -1}, {0, -1, 0}},     // left, x = 0
+    };
+    const int32_t offsets[4] = {0, W - 1, W - 1 + D - 1, 2 * (W - 1) + D - 1};
+    const int32_t band = 2 * (W - 1) + 2 * (D - 1);
+
+    // Text enters at the end of the band and moves towards its start; restart once it has left
+    const int32_t text_w = (int32_t)raster::text_width(text_);
+    int32_t head = band - (int32_t)((uint64_t)elapsed_ms_ * columns_per_s_ / 1000);
+    if (head + text_w <= 0) {
+        elapsed_ms_ = 0;
+        head = band;
+    }
+
+    target.clear();
+    const int32_t v0 = (H - (K_FONT_HEIGHT - 1)) / 2; // the font's last row is spacing
+    for (int i = 0; i < 4; ++i)
+        raster::draw_text(target, walls[i], text_, head - offsets[i], v0 > 0 ? v0 : 0, color_);
+}
+
+} // namespace scroll_text_animation
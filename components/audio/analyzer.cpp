@@ -0,0 +1,116 @@
+#include "audio.hpp"
+#include <math.h>
+#include <string.h>
+
+namespace audio {
+
+// Levels are log2 of power in 1/256 units; one such unit of power is 3.0103/256 dB
+static constexpr int32_t db_to_log(int32_t db) { return db * 256 * 1000 / 3010; }
+// A full-scale sine through the Hann window peaks at 32767 * N / 4 in its bin
+static constexpr int32_t K_FULL_SCALE_LOG = 2 * (15 + K_AUDIO_FFT_BITS - 2) * 256;
+
+// log2(v) in 1/256 units, the mantissa interpolated linearly; v > 0
+static inline int32_t log2_q8(uint64_t v) {
+    const int msb = 63 - __builtin_clzll(v);
+    const uint32_t frac = msb >= 8 ? (uint32_t)(v >> (msb - 8)) & 0xFF : (uint32_t)(v << (8 - msb)) & 0xFF;
+    return msb * 256 + (int32_t)frac;
+}
+
+static inline uint8_t to_u8(int32_t v, int32_t range) {
+    if (v <= 0) return 0;
+    if (v >= range) return 255;
+    return (uint8_t)(v * 255 / range);
+}
+
+Analyzer::Analyzer(uint32_t sample_rate) : fft_(K_AUDIO_FFT_BITS) {
+    for (int i = 0; i < K_AUDIO_FFT_SIZE; ++i) {
+        const float w = 0.5f - 0.5f * cosf(6.2831853f * (float)i / (float)K_AUDIO_FFT_SIZE);
+        window_[i] = (int16_t)lrintf(w * 32767.0f);
+    }
+    memset(history_, 0, sizeof(history_));
+
+    // Logarithmic band edges from K_AUDIO_MIN_HZ to Nyquist, each band at least one bin wide
+    const float nyquist = (float)sample_rate / 2;
+    const float hz_per_bin = (float)sample_rate / K_AUDIO_FFT_SIZE;
+    const float ratio = nyquist / K_AUDIO_MIN_HZ;
+    for (int b = 0; b <= K_AUDIO_BANDS; ++b) {
+        const float hz = K_AUDIO_MIN_HZ * powf(ratio, (float)b / K_AUDIO_BANDS);
+        uint32_t bin = (uint32_t)lrintf(hz / hz_per_bin);
+        if (bin < 1) bin = 1;
+        if (b > 0 && bin <= band_edge_[b - 1]) bin = band_edge_[b - 1] + 1u;
+        band_edge_[b] = (uint16_t)bin;
+    }
+    // Pushing the narrow low bands apart may run the top past Nyquist; pull it back in
+    band_edge_[K_AUDIO_BANDS] = K_AUDIO_FFT_SIZE / 2;
+    for (int b = K_AUDIO_BANDS - 1; b >= 0 && band_edge_[b] >= band_edge_[b + 1]; --b)
+        band_edge_[b] = (uint16_t)(band_edge_[b + 1] - 1);
+
+    peak_ = db_to_log(K_AUDIO_GATE_DB + K_AUDIO_RANGE_DB);
+    bass_avg_ = db_to_log(K_AUDIO_GATE_DB); // start from silence, so a first loud hop is a beat
+    peak_decay_ = db_to_log(K_AUDIO_PEAK_DECAY_DB_S) * K_AUDIO_HOP / (int32_t)sample_rate;
+    if (peak_decay_ < 1) peak_decay_ = 1;
+}
+
+const Features &Analyzer::process(const int16_t *hop, int64_t time_us) {
+    memmove(history_, history_ + K_AUDIO_HOP, sizeof(int16_t) * (K_AUDIO_FFT_SIZE - K_AUDIO_HOP));
+    memcpy(history_ + K_AUDIO_FFT_SIZE - K_AUDIO_HOP, hop, sizeof(int16_t) * K_AUDIO_HOP);
+    for (int i = 0; i < K_AUDIO_FFT_SIZE; ++i)
+        buf_[i] = cq15{(int16_t)(((int32_t)history_[i] * window_[i]) >> 15), 0};
+    // The true DFT is buf_ * 2^shift, so its power is 4^shift times larger
+    const int32_t offset = 2 * 256 * fft_.run(buf_) - K_FULL_SCALE_LOG;
+
+    // Power per band; the input is real, so the upper half of the spectrum mirrors the lower
+    uint64_t band_power[K_AUDIO_BANDS];
+    uint64_t total = 0;
+    for (int b = 0; b < K_AUDIO_BANDS; ++b) {
+        uint64_t p = 0;
+        for (uint32_t k = band_edge_[b]; k < band_edge_[b + 1]; ++k)
+            p += (uint64_t)((int32_t)buf_[k].re * buf_[k].re + (int32_t)buf_[k].im * buf_[k].im);
+        band_power[b] = p;
+        total += p;
+    }
+    auto level_of = [&](uint64_t p) { return p ? log2_q8(p) + offset : INT32_MIN / 2; };
+
+    Features &f = features_;
+    ++f.frame;
+    f.time_us = time_us;
+    const int32_t gate = db_to_log(K_AUDIO_GATE_DB);
+    f.level = to_u8(level_of(total) - gate, -gate);
+
+    // Bands are scaled against the loudest recent band, which decays slowly and never drops
+    // so low that noise under the gate would show
+    const int32_t range = db_to_log(K_AUDIO_RANGE_DB);
+    int32_t levels[K_AUDIO_BANDS];
+    int32_t loudest = INT32_MIN / 2;
+    for (int b = 0; b < K_AUDIO_BANDS; ++b) {
+        levels[b] = level_of(band_power[b]);
+        if (levels[b] > loudest) loudest = levels[b];
+    }
+    peak_ -= peak_decay_;
+    if (loudest > peak_) peak_ = loudest;
+    if (peak_ < gate + range) peak_ = gate + range;
+    for (int b = 0; b < K_AUDIO_BANDS; ++b)
+        f.bands[b] = to_u8(levels[b] - (peak_ - range), range);
+
+    // Beats: the bass energy jumping above its running average
+    uint64_t bass_power = 0;
+    for (int b = 0; b < K_AUDIO_BASS_BANDS; ++b)
+        bass_power += band_power[b];
+    // Floored at the gate, so silence does not drag the average out of reach
+    int32_t bass = level_of(bass_power);
+    if (bass < gate) bass = gate;
+    const int32_t rise = bass - bass_avg_;
+    const int32_t min_rise = db_to_log(K_AUDIO_BEAT_MIN_RISE_DB);
+    const int32_t threshold = 2 * bass_dev_ > min_rise ? 2 * bass_dev_ : min_rise;
+    if (rise > threshold && bass > gate && time_us - last_beat_us_ >= K_AUDIO_BEAT_REFRACTORY_US) {
+        ++f.beats;
+        f.beat_strength = to_u8(rise, db_to_log(24));
+        last_beat_us_ = time_us;
+    }
+    // Averages over roughly 16 hops (a quarter second)
+    bass_avg_ += (bass - bass_avg_) / 16;
+    bass_dev_ += ((rise < 0 ? -rise : rise) - bass_dev_) / 16;
+    return f;
+}
+
+} // namespace audio
@@ -0,0 +1,166 @@
+#include "audio_anim.hpp"
+#include "fixed.hpp"
+#include "raster.hpp"
+#include "utils.hpp"
+#include <math.h>
+#include <string.h>
+
+namespace audio_animation {
+
+using namespace utils;
+
+// How much of the previous frame survives each step as it moves back through the waterfall
+#define SPECTRUM_WATERFALL_FADE 150
+
+void SpectrumAnim::init(Frame &target) {
+    features_ = Features{};
+    memset(peak_, 0, sizeof(peak_));
+    target.clear();
+}
+
+void SpectrumAnim::step(Frame &target, uint32_t dt_ms) {
+    feed_.read(features_);
+    const uint32_t w = target.width(), h = target.height(), d = target.depth();
+
+    // Age the waterfall: dim everything and move each face one step back
+    target.fade(SPECTRUM_WATERFALL_FADE);
+    if (d > 1) memmove(target.layer(1), target.layer(0), sizeof(rgb_t) * (size_t)w * h * (d - 1));
+    target.fill_layer(0, rgb_t{0, 0, 0});
+
+    // Peaks fall the full height in one second
+    const uint32_t fall = h * 256 * dt_ms / 1000;
+    for (uint32_t x = 0; x < w; ++x) {
+        // Columns share out the bands: the loudest band of a group sets its height
+        const uint32_t b0 = x * K_AUDIO_BANDS / w;
+        uint32_t b1 = (x + 1) * K_AUDIO_BANDS / w;
+        if (b1 <= b0) b1 = b0 + 1;
+        uint8_t level = 0;
+        for (uint32_t b = b0; b < b1; ++b)
+            if (features_.bands[b] > level) level = features_.bands[b];
+
+        const uint32_t top = (uint32_t)level * h * 256 / 255; // 1/256 rows
+        peak_[x] = (uint16_t)(peak_[x] > fall ? peak_[x] - fall : 0);
+        if (top > peak_[x]) peak_[x] = (uint16_t)top;
+
+        // Green at the bottom through yellow to red at the top
+        const uint32_t rows = (top + 128) >> 8;
+        for (uint32_t y = 0; y < rows; ++y)
+            target.at(x, y, 0) = color_wheel((uint8_t)(85 - 85 * y / (h > 1 ? h - 1 : 1)));
+        const uint32_t peak_row = peak_[x] >> 8;
+        if (peak_[x] && peak_row < h) target.at(x, peak_row, 0) = rgb_t{255, 255, 255};
+    }
+}
+
+void BeatBurstAnim::init(Frame &target) {
+    if (sparks_.capacity() == 0) {
+        sparks_.reserve(MAX_SPARKS);
+        sparks_.set_fade_with_age(true);
+        sparks_.set_blend(particles::Blend::Add);
+    }
+    sparks_.set_bounds(target.width(), target.height(), target.depth());
+    sparks_.clear();
+    rng_.seed(rng_seed());
+    for (Burst &b : bursts_)
+        b.live = false;
+    // Only beats from now on start bursts
+    features_ = Features{};
+    feed_.read(features_);
+    beats_seen_ = features_.beats;
+    hue_ = 0;
+    target.clear();
+}
+
+void BeatBurstAnim::start_burst(const Frame &frame, uint8_t strength) {
+    // Reuse a finished slot, else the oldest burst
+    Burst *slot = &bursts_[0];
+    for (Burst &b : bursts_) {
+        if (!b.live) {
+            slot = &b;
+            break;
+        }
+        if (b.age_ms > slot->age_ms) slot = &b;
+    }
+    // Successive beats step round the colour wheel
+    hue_ = (uint8_t)(hue_ + 37);
+    *slot = Burst{0, color_wheel(hue_), strength, true};
+
+    const float cx = frame.width() * 0.5f;
+    const float cy = frame.height() * 0.5f;
+    const float cz = frame.depth() * 0.5f;
+    const float w1 = frame.width() - 1.0f, h1 = frame.height() - 1.0f, d1 = frame.depth() - 1.0f;
+    const float reach = sqrtf(w1 * w1 + h1 * h1 + d1 * d1) / 2.0f; // centre to corner
+    const uint32_t count = 8 + (uint32_t)strength * (MAX_SPARKS / 2) / 255;
+    for (uint32_t i = 0; i < count; ++i) {
+        // Random direction: rejection-sample the unit ball
+        float dx, dy, dz, len2;
+        do {
+            dx = rng_.unit() * 2.0f - 1.0f;
+            dy = rng_.unit() * 2.0f - 1.0f;
+            dz = rng_.unit() * 2.0f - 1.0f;
+            len2 = dx * dx + dy * dy + dz * dz;
+        } while (len2 > 1.0f || len2 < 0.01f);
+        // Voxels per second: out to the corners within the spark's life
+        const float v = reach * (1.5f + rng_.unit()) / sqrtf(len2);
+
+        particles::Emit e{};
+        e.x = particles::to_fx(cx);
+        e.y = particles::to_fx(cy);
+        e.z = particles::to_fx(cz);
+        e.vx = particles::to_fx(dx * v);
+        e.vy = particles::to_fx(dy * v);
+        e.vz = particles::to_fx(dz * v);
+        e.life_ms = (uint16_t)rng_.range(300, 599);
+        // Whiter than the shell, so they stand out against it
+        e.color = rgb_t{(uint8_t)(128 + slot->color.r / 2), (uint8_t)(128 + slot->color.g / 2),
+                        (uint8_t)(128 + slot->color.b / 2)};
+        if (!sparks_.spawn(e)) break;
+    }
+}
+
+void BeatBurstAnim::step(Frame &target, uint32_t dt_ms) {
+    feed_.read(features_);
+    if (features_.beats != beats_seen_) {
+        // Several beats between two frames still make one burst
+        beats_seen_ = features_.beats;
+        start_burst(target, features_.beat_strength);
+    }
+
+    // Background glow with the loudness, dim blue
+    target.fill(rgb_t{0, 0, (uint8_t)(features_.level / 8)});
+
+    const fx::vec3 center{fx::from_int(target.width() - 1) / 2, fx::from_int(target.height() - 1) / 2,
+                          fx::from_int(target.depth() - 1) / 2};
+    const uint32_t w1 = target.width() - 1, h1 = target.height() - 1, d1 = target.depth() - 1;
+    const fx::q16 max_radius = fx::sqrt(fx::from_int((int32_t)(w1 * w1 + h1 * h1 + d1 * d1)) / 4);
+    // Oldest first, so the newest shell is drawn on top
+    Burst *order[MAX_BURSTS];
+    size_t n = 0;
+    for (Burst &b : bursts_)
+        if (b.live) order[n++] = &b;
+    for (size_t i = 1; i < n; ++i)
+        for (size_t j = i; j > 0 && order[j]->age_ms > order[j - 1]->age_ms; --j) {
+            Burst *t = order[j];
+            order[j] = order[j - 1];
+            order[j - 1] = t;
+        }
+    for (size_t i = 0; i < n; ++i) {
+        Burst &b = *order[i];
+        b.age_ms += dt_ms;
+        if (b.age_ms >= BURST_MS) {
+            b.live = false;
+            continue;
+        }
+        // The shell grows to the corners and fades as it goes; the beat's strength sets how
+        // bright it starts (never below half)
+        const fx::q16 t = (fx::q16)((int64_t)b.age_ms * K_Q16_ONE / BURST_MS);
+        const fx::q16 radius = fx::mul(max_radius, t);
+        const uint8_t fade = (uint8_t)(((K_Q16_ONE - t) * 255) >> K_Q16_SHIFT);
+        const uint8_t brightness = scale8(fade, (uint8_t)(128 + b.strength / 2));
+        const fx::q16 half = K_Q16_ONE * 3 / 4; // shell half-thickness, in voxels
+        raster::sphere_shell(target, center, radius > half ? radius - half : 0, radius + half,
+                             scale(b.color, brightness));
+    }
+    sparks_.step(target, dt_ms);
+}
+
+} // namespace audio_animation
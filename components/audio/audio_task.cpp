@@ -0,0 +1,62 @@
+#include "audio.hpp"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/task.h"
+#include <atomic>
+#include <new>
+
+namespace audio {
+
+static const char *TAG = "audio";
+
+static SampleSource *s_source = nullptr;
+static Feed *s_feed = nullptr;
+static Analyzer *s_analyzer = nullptr;
+static TaskHandle_t s_task = nullptr;
+static std::atomic<uint32_t> s_read_errors{0};
+static std::atomic<uint32_t> s_overruns{0};
+
+static void audio_task(void *) {
+    static int16_t hop[K_AUDIO_HOP];
+    const int64_t hop_us = (int64_t)K_AUDIO_HOP * 1000000 / s_source->sample_rate();
+    while (true) {
+        size_t got = 0;
+        while (got < K_AUDIO_HOP) {
+            const size_t n = s_source->read(hop + got, K_AUDIO_HOP - got);
+            if (n == 0) {
+                // No data (driver error or end of stream): back off rather than spin
+                s_read_errors.fetch_add(1, std::memory_order_relaxed);
+                vTaskDelay(pdMS_TO_TICKS(10));
+            }
+            got += n;
+        }
+
+        // The hop's last sample has just arrived
+        const int64_t t0 = esp_timer_get_time();
+        s_feed->write(s_analyzer->process(hop, t0));
+        if (esp_timer_get_time() - t0 > hop_us) s_overruns.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+esp_err_t start(SampleSource &source, Feed &feed, UBaseType_t priority, uint32_t stack_size) {
+    if (s_task) return ESP_ERR_INVALID_STATE;
+    if (source.sample_rate() == 0) return ESP_ERR_INVALID_ARG;
+    s_analyzer = new (std::nothrow) Analyzer(source.sample_rate());
+    if (!s_analyzer) return ESP_ERR_NO_MEM;
+    s_source = &source;
+    s_feed = &feed;
+    if (xTaskCreate(audio_task, "audio", stack_size, nullptr, priority, &s_task) != pdPASS) {
+        delete s_analyzer;
+        s_analyzer = nullptr;
+        return ESP_ERR_NO_MEM;
+    }
+    ESP_LOGI(TAG, "analysing %lu Hz audio, %d-point FFT every %d samples", (unsigned long)source.sample_rate(),
+             K_AUDIO_FFT_SIZE, K_AUDIO_HOP);
+    return ESP_OK;
+}
+
+uint32_t read_errors() { return s_read_errors.load(std::memory_order_relaxed); }
+
+uint32_t overruns() { return s_overruns.load(std::memory_order_relaxed); }
+
+} // namespace audio
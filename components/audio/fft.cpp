@@ -0,0 +1,64 @@
+#include "fft.hpp"
+#include <math.h>
+
+namespace audio {
+
+Fft::Fft(uint32_t bits) : bits_(bits), n_(1u << bits), twiddle_(new cq15[n_ / 2]) {
+    for (uint32_t k = 0; k < n_ / 2; ++k) {
+        const float a = -6.2831853f * (float)k / (float)n_;
+        twiddle_[k] = cq15{(int16_t)lrintf(cosf(a) * 32767.0f), (int16_t)lrintf(sinf(a) * 32767.0f)};
+    }
+}
+
+static inline uint32_t reverse_bits(uint32_t v, uint32_t bits) {
+    uint32_t r = 0;
+    for (uint32_t i = 0; i < bits; ++i, v >>= 1)
+        r = (r << 1) | (v & 1);
+    return r;
+}
+
+// A butterfly grows a component by at most 1 + sqrt(2); shifting by 2 from half scale up and
+// by 1 from a quarter keeps every output below 19777, inside int16 with room for the next check
+static inline int stage_shift(const cq15 *x, uint32_t n) {
+    int32_t peak = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        const int32_t re = x[i].re < 0 ? -x[i].re : x[i].re;
+        const int32_t im = x[i].im < 0 ? -x[i].im : x[i].im;
+        peak |= re | im;
+    }
+    return peak >= 16384 ? 2 : peak >= 8192 ? 1 : 0;
+}
+
+int Fft::run(cq15 *x) const {
+    for (uint32_t i = 0; i < n_; ++i) {
+        const uint32_t j = reverse_bits(i, bits_);
+        if (j > i) {
+            const cq15 t = x[i];
+            x[i] = x[j];
+            x[j] = t;
+        }
+    }
+
+    int total = 0;
+    for (uint32_t half = 1, step = n_ / 2; half < n_; half <<= 1, step >>= 1) {
+        const int shift = stage_shift(x, n_);
+        total += shift;
+        for (uint32_t i = 0; i < n_; i += 2 * half) {
+            for (uint32_t j = 0; j < half; ++j) {
+                const cq15 w = twiddle_[j * step];
+                cq15 &a = x[i + j];
+                cq15 &b = x[i + j + half];
+                const int32_t tr = ((int32_t)b.re * w.re - (int32_t)b.im * w.im) >> 15;
+                const int32_t ti = ((int32_t)b.re * w.im + (int32_t)b.im * w.re) >> 15;
+                const int32_t ar = a.re, ai = a.im;
+                a.re = (int16_t)((ar + tr) >> shift);
+                a.im = (int16_t)((ai + ti) >> shift);
+                b.re = (int16_t)((ar - tr) >> shift);
+                b.im = (int16_t)((ai - ti) >> shift);
+            }
+        }
+    }
+    return total;
+}
+
+} // namespace audio
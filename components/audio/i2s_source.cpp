@@ -0,0 +1,60 @@
+#include "i2s_source.hpp"
+#include "esp_attr.h"
+
+namespace audio {
+
+esp_err_t I2sSource::init(const I2sMicConfig &cfg) {
+    if (rx_) return ESP_ERR_INVALID_STATE;
+    if (cfg.sample_rate == 0 || cfg.shift > 16) return ESP_ERR_INVALID_ARG;
+    cfg_ = cfg;
+
+    i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(I2S_NUM_AUTO, I2S_ROLE_MASTER);
+    chan_cfg.dma_desc_num = K_AUDIO_I2S_DMA_BUFS;
+    chan_cfg.dma_frame_num = K_AUDIO_I2S_DMA_FRAMES;
+    esp_err_t err = i2s_new_channel(&chan_cfg, nullptr, &rx_);
+    if (err != ESP_OK) return err;
+
+    i2s_std_config_t std_cfg = {
+        .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(cfg.sample_rate),
+        .slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_32BIT, I2S_SLOT_MODE_MONO),
+        .gpio_cfg = {},
+    };
+    std_cfg.slot_cfg.slot_mask = cfg.right_slot ? I2S_STD_SLOT_RIGHT : I2S_STD_SLOT_LEFT;
+    std_cfg.gpio_cfg.mclk = I2S_GPIO_UNUSED;
+    std_cfg.gpio_cfg.bclk = cfg.bclk;
+    std_cfg.gpio_cfg.ws = cfg.ws;
+    std_cfg.gpio_cfg.dout = I2S_GPIO_UNUSED;
+    std_cfg.gpio_cfg.din = cfg.din;
+
+    i2s_event_callbacks_t cbs = {};
+    cbs.on_recv_q_ovf = on_overflow;
+    err = i2s_channel_init_std_mode(rx_, &std_cfg);
+    if (err == ESP_OK) err = i2s_channel_register_event_callback(rx_, &cbs, this);
+    if (err == ESP_OK) err = i2s_channel_enable(rx_);
+    if (err != ESP_OK) {
+        i2s_del_channel(rx_);
+        rx_ = nullptr;
+    }
+    return err;
+}
+
+bool IRAM_ATTR I2sSource::on_overflow(i2s_chan_handle_t, i2s_event_data_t *, void *ctx) {
+    static_cast<I2sSource *>(ctx)->overruns_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+size_t I2sSource::read(int16_t *dst, size_t n) {
+    if (!rx_) return 0;
+    if (n > K_AUDIO_I2S_DMA_FRAMES) n = K_AUDIO_I2S_DMA_FRAMES;
+    size_t bytes = 0;
+    if (i2s_channel_read(rx_, slots_, n * sizeof(int32_t), &bytes, K_AUDIO_I2S_READ_TIMEOUT_MS) != ESP_OK) return 0;
+
+    const size_t got = bytes / sizeof(int32_t);
+    for (size_t i = 0; i < got; ++i) {
+        const int32_t v = slots_[i] >> cfg_.shift;
+        dst[i] = (int16_t)(v > INT16_MAX ? INT16_MAX : v < INT16_MIN ? INT16_MIN : v);
+    }
+    return got;
+}
+
+} // namespace audio
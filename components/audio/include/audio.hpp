@@ -0,0 +1,96 @@
+#pragma once
+
+#include "esp_err.h"
+#include "fft.hpp"
+#include "freertos/FreeRTOS.h"
+#include "seqlock.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+// Audio analysis for the audio-reactive animations. A SampleSource delivers mono 16-bit PCM
+// (an I2S microphone on the device, a WAV file on the host); the Analyzer windows it, runs
+// the fixed-point FFT and reduces every hop to band levels, overall loudness and beats. The
+// audio task publishes each result to a Feed, which the render task reads without locking.
+namespace audio {
+
+#define K_AUDIO_SAMPLE_RATE 16000
+#define K_AUDIO_FFT_BITS 9
+#define K_AUDIO_FFT_SIZE (1 << K_AUDIO_FFT_BITS)
+// Samples between analyses: 16 ms at 16 kHz, with the FFT windows overlapping by half
+#define K_AUDIO_HOP (K_AUDIO_FFT_SIZE / 2)
+#define K_AUDIO_BANDS 16
+// Lower edge of the first band; band edges are spaced logarithmically up to Nyquist
+#define K_AUDIO_MIN_HZ 60
+// Beats are detected on the energy of the lowest bands (up to about 375 Hz at 16 kHz)
+#define K_AUDIO_BASS_BANDS 6
+// A beat is a rise of the bass energy above its running average by twice its usual
+// deviation, and by at least K_AUDIO_BEAT_MIN_RISE_DB
+#define K_AUDIO_BEAT_MIN_RISE_DB 6
+#define K_AUDIO_BEAT_REFRACTORY_US (250 * 1000)
+// Band levels span this many dB below the loudest recent band (which decays by
+// K_AUDIO_PEAK_DECAY_DB_S), and nothing under K_AUDIO_GATE_DB full scale shows at all
+#define K_AUDIO_RANGE_DB 36
+#define K_AUDIO_PEAK_DECAY_DB_S 6
+#define K_AUDIO_GATE_DB (-60)
+#define K_AUDIO_TASK_STACK 4096
+// Above the render task, so a Feed write is never preempted by the reader
+#define K_AUDIO_TASK_PRIO 6
+
+// One analysis result. Readers sample it at their own frame rate, so beats are counted
+// rather than flagged: a beat happened if `beats` changed since the last read.
+struct Features {
+    uint32_t frame;              // analyses since start; 0 until the first one is published
+    uint32_t beats;              // beats detected since start
+    int64_t time_us;             // esp_timer time at which the analysed audio was captured
+    uint8_t bands[K_AUDIO_BANDS]; // per band, 0..255 over K_AUDIO_RANGE_DB, low to high
+    uint8_t level;               // overall loudness, 0..255 from K_AUDIO_GATE_DB to full scale
+    uint8_t beat_strength;       // how far the last beat rose above the bass average, 0..255
+};
+
+using Feed = utils::Seqlock<Features>;
+
+// Mono 16-bit PCM input
+class SampleSource {
+  public:
+    virtual ~SampleSource() = default;
+    virtual uint32_t sample_rate() const = 0;
+    // Read up to `n` samples, blocking until some are available; 0 at the end of the
+    // stream or on an error
+    virtual size_t read(int16_t *dst, size_t n) = 0;
+};
+
+// Turns hops of K_AUDIO_HOP samples into Features. Integer only apart from building its
+// tables in the constructor; about 5 KB, so keep one in static storage or on the heap.
+class Analyzer {
+  public:
+    explicit Analyzer(uint32_t sample_rate = K_AUDIO_SAMPLE_RATE);
+
+    // Analyse the newest hop together with the previous one; `time_us` is its capture time
+    const Features &process(const int16_t *hop, int64_t time_us);
+    const Features &features() const { return features_; }
+
+  private:
+    Fft fft_;
+    int16_t window_[K_AUDIO_FFT_SIZE];  // Hann, Q15
+    int16_t history_[K_AUDIO_FFT_SIZE]; // the last two hops
+    cq15 buf_[K_AUDIO_FFT_SIZE];
+    uint16_t band_edge_[K_AUDIO_BANDS + 1]; // first FFT bin of each band, then the end
+    int32_t peak_;      // loudest recent band, log2 of power in 1/256 units (as all levels here)
+    int32_t peak_decay_; // per hop
+    int32_t bass_avg_;
+    int32_t bass_dev_ = 0; // running mean absolute deviation from bass_avg_
+    int64_t last_beat_us_ = INT64_MIN / 2;
+    Features features_ = {};
+};
+
+// Start the audio task: it reads hops from `source`, analyses them and writes every result to
+// `feed`. Both must outlive the task.
+esp_err_t start(SampleSource &source, Feed &feed, UBaseType_t priority = K_AUDIO_TASK_PRIO,
+                uint32_t stack_size = K_AUDIO_TASK_STACK);
+
+// Reads that returned no samples, and hops whose analysis took longer than the hop lasts
+// (the task cannot keep up, and capture is falling behind)
+uint32_t read_errors();
+uint32_t overruns();
+
+} // namespace audio
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "audio.hpp"
+#include "common.hpp"
+#include "particles.hpp"
+
+// Animations driven by the audio Feed. They read the newest Features at the start of every
+// step and never wait for the audio task; if a read loses the race with a write they reuse
+// the previous frame's Features.
+namespace audio_animation {
+
+using namespace anim_common;
+using audio::Features;
+using audio::Feed;
+
+// Frame period of the audio animations: short, so the cube follows the music closely
+#define K_AUDIO_ANIM_FRAME_MS 30
+
+// Spectrum analyser: one column per band group across the front face, height and colour
+// from the band level, with a falling peak dot. Every frame the picture moves one face
+// back and dims, so the depth of the cube shows the last few frames as a waterfall.
+class SpectrumAnim : public IAnimation {
+  public:
+    explicit SpectrumAnim(const Feed &feed) : feed_(feed) {}
+
+    void init(Frame &target) override;
+    void step(Frame &target, uint32_t dt_ms) override;
+    uint32_t frame_period_ms() const override { return K_AUDIO_ANIM_FRAME_MS; }
+    const char *name() const override { return "spectrum"; }
+
+  private:
+    const Feed &feed_;
+    Features features_ = {};
+    uint16_t peak_[K_MAX_WIDTH] = {}; // per column, in 1/256 of a row
+};
+
+// A burst in the style of the countdown's explosion on every beat: a coloured shell grows
+// from the centre and fades, with sparks flying out; stronger beats throw more sparks.
+// Between beats the cube glows faintly with the overall level.
+class BeatBurstAnim : public IAnimation {
+  public:
+    explicit BeatBurstAnim(const Feed &feed) : feed_(feed) {}
+
+    void init(Frame &target) override;
+    void step(Frame &target, uint32_t dt_ms) override;
+    uint32_t frame_period_ms() const override { return K_AUDIO_ANIM_FRAME_MS; }
+    const char *name() const override { return "beat_burst"; }
+
+  private:
+    static constexpr size_t MAX_BURSTS = 4;
+    static constexpr uint16_t MAX_SPARKS = 96;
+    static constexpr uint32_t BURST_MS = 500;
+
+    struct Burst {
+        uint32_t age_ms;
+        rgb_t color;
+        uint8_t strength;
+        bool live;
+    };
+
+    void start_burst(const Frame &frame, uint8_t strength);
+
+    const Feed &feed_;
+    Features features_ = {};
+    uint32_t beats_seen_ = 0;
+    uint8_t hue_ = 0;
+    Burst bursts_[MAX_BURSTS] = {};
+    particles::ParticleSystem sparks_;
+    utils::Rng rng_;
+};
+
+} // namespace audio_animation
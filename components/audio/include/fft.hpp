@@ -0,0 +1,35 @@
+#pragma once
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace audio {
+
+// Complex Q15 sample
+struct cq15 {
+    int16_t re, im;
+};
+
+// In-place radix-2 FFT (decimation in time) on Q15 data, integer only, with block floating
+// point: each stage halves or quarters its outputs only when its inputs are large enough to
+// overflow, and run() returns the total shift. Quiet input keeps its precision instead of
+// losing one bit per stage.
+class Fft {
+  public:
+    // Transform length 1 << bits, 2..12 bits
+    explicit Fft(uint32_t bits);
+
+    uint32_t size() const { return n_; }
+
+    // Transform x[0, size()) in place. The result is the DFT divided by 2^(returned shift);
+    // inputs may use the full int16 range.
+    int run(cq15 *x) const;
+
+  private:
+    uint32_t bits_;
+    uint32_t n_;
+    std::unique_ptr<cq15[]> twiddle_; // e^(-2 pi i k / n) for k < n / 2, Q15
+};
+
+} // namespace audio
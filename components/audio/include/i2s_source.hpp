@@ -0,0 +1,46 @@
+#pragma once
+
+#include "audio.hpp"
+#include "driver/i2s_std.h"
+#include <atomic>
+
+namespace audio {
+
+// DMA buffering between the microphone and the audio task: K_AUDIO_I2S_DMA_BUFS buffers of
+// K_AUDIO_I2S_DMA_FRAMES samples each (32 ms at 16 kHz), which bounds how stale a hop can be
+#define K_AUDIO_I2S_DMA_BUFS 4
+#define K_AUDIO_I2S_DMA_FRAMES 128
+#define K_AUDIO_I2S_READ_TIMEOUT_MS 100
+
+// I2S MEMS microphone (INMP441, SPH0645 and the like): 24-bit samples left-justified in
+// 32-bit slots, one channel
+struct I2sMicConfig {
+    gpio_num_t bclk;
+    gpio_num_t ws;
+    gpio_num_t din;
+    uint32_t sample_rate = K_AUDIO_SAMPLE_RATE;
+    bool right_slot = false; // the mic's L/R pin is tied high
+    // Right shift from the 32-bit slot to 16 bits; below 16 adds gain for quiet mics
+    uint8_t shift = 14;
+};
+
+class I2sSource : public SampleSource {
+  public:
+    esp_err_t init(const I2sMicConfig &cfg);
+
+    uint32_t sample_rate() const override { return cfg_.sample_rate; }
+    size_t read(int16_t *dst, size_t n) override;
+
+    // DMA buffers the driver overwrote before they were read
+    uint32_t overruns() const { return overruns_.load(std::memory_order_relaxed); }
+
+  private:
+    static bool on_overflow(i2s_chan_handle_t handle, i2s_event_data_t *event, void *ctx);
+
+    I2sMicConfig cfg_ = {};
+    i2s_chan_handle_t rx_ = nullptr;
+    int32_t slots_[K_AUDIO_I2S_DMA_FRAMES];
+    std::atomic<uint32_t> overruns_{0};
+};
+
+} // namespace audio
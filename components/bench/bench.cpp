@@ -0,0 +1,134 @@
+#include "bench.hpp"
+#include "circle.hpp"
+#include "compositor.hpp"
+#include "countdown.hpp"
+#include "esp_cpu.h"
+#include "esp_timer.h"
+#include "noise_anim.hpp"
+#include "rain.hpp"
+#include "scroll_text.hpp"
+#include <stdio.h>
+
+namespace bench {
+
+using namespace rain_animation;
+using namespace countdown_animation;
+using namespace circle_animation;
+using namespace scroll_text_animation;
+using namespace noise_animation;
+using cube::BlendMode;
+
+BenchResult run_animation(Cube &cube, IAnimation &anim, uint32_t frames) {
+    BenchResult r;
+    r.name = anim.name();
+    r.frames = frames;
+
+    anim.init(cube.frame());
+    ESP_ERROR_CHECK(cube.wait_idle());
+    r.budget_ms = anim.frame_period_ms();
+
+    const uint64_t bytes_before = cube.bytes_sent();
+    const uint32_t dt_ms = r.budget_ms;
+    for (uint32_t f = 0; f < frames; ++f) {
+        const int64_t t0 = esp_timer_get_time();
+        const uint32_t c0 = esp_cpu_get_cycle_count();
+
+        anim.step(cube.frame(), dt_ms);
+        ESP_ERROR_CHECK(cube.show());
+        anim.prefetch();
+
+        // 32-bit counter: per-frame deltas stay correct across a wrap
+        r.cycles += static_cast<uint32_t>(esp_cpu_get_cycle_count() - c0);
+        const uint32_t us = static_cast<uint32_t>(esp_timer_get_time() - t0);
+        r.elapsed_us += us;
+        if (us > r.worst_us) r.worst_us = us;
+    }
+    ESP_ERROR_CHECK(cube.wait_idle());
+    r.bytes = cube.bytes_sent() - bytes_before;
+    return r;
+}
+
+BenchResult run_transition(Cube &cube, const char *name, IAnimation &a, IAnimation &b, render::TransitionKind kind,
+                           uint32_t frames) {
+    BenchResult r;
+    r.name = name;
+    r.frames = frames;
+
+    render::TransitionEngine engine;
+    IAnimation *from = &a, *to = &b;
+    from->init(cube.frame());
+    ESP_ERROR_CHECK(cube.wait_idle());
+    r.budget_ms = b.frame_period_ms() < a.frame_period_ms() ? b.frame_period_ms() : a.frame_period_ms();
+
+    const uint64_t bytes_before = cube.bytes_sent();
+    for (uint32_t f = 0; f < frames; ++f) {
+        const int64_t t0 = esp_timer_get_time();
+        const uint32_t c0 = esp_cpu_get_cycle_count();
+
+        if (!engine.active()) {
+            engine.begin(cube, from, to, kind, K_RENDER_TRANSITION_FRAMES);
+            IAnimation *t = from;
+            from = to;
+            to = t;
+        }
+        engine.step(cube, r.budget_ms);
+        ESP_ERROR_CHECK(cube.show());
+        engine.prefetch();
+
+        r.cycles += static_cast<uint32_t>(esp_cpu_get_cycle_count() - c0);
+        const uint32_t us = static_cast<uint32_t>(esp_timer_get_time() - t0);
+        r.elapsed_us += us;
+        if (us > r.worst_us) r.worst_us = us;
+    }
+    engine.finish(cube);
+    ESP_ERROR_CHECK(cube.wait_idle());
+    r.bytes = cube.bytes_sent() - bytes_before;
+    return r;
+}
+
+void print_header() {
+    printf("\n%-12s %7s %9s %12s %10s %10s %8s\n", "animation", "frames", "fps", "cycles/frm", "worst_us", "bytes",
+           "budget");
+}
+
+void print_result(const BenchResult &r) {
+    printf("%-12s %7lu %9lu %12lu %10lu %10llu %5lums%s\n", r.name, (unsigned long)r.frames, (unsigned long)r.fps(),
+           (unsigned long)r.cycles_per_frame(), (unsigned long)r.worst_us, (unsigned long long)r.bytes,
+           (unsigned long)r.budget_ms, r.over_budget() ? " OVER" : "");
+}
+
+void run_all(Cube &cube, uint32_t frames) {
+    static LightRainAnim light_rain;
+    static HeavyRainAnim heavy_rain;
+    static CountdownAnim countdown;
+    static CircleSpinAnim circle_spin;
+    static ScrollTextAnim scroll_text;
+    static PlasmaAnim plasma;
+    static FireAnim fire;
+    static CloudsAnim clouds;
+
+    // Four layers, one per blend mode, to size the compositor's cost
+    static CircleSpinAnim l_disc;
+    static HeavyRainAnim l_rain;
+    static ScrollTextAnim l_text;
+    static CountdownAnim l_countdown;
+    const compositor::Layer layers[] = {
+        {&l_disc, BlendMode::Alpha, 255},
+        {&l_rain, BlendMode::Add, 192},
+        {&l_text, BlendMode::Max, 255},
+        {&l_countdown, BlendMode::Multiply, 128},
+    };
+    static compositor::Compositor layers4("layers4", layers, 4);
+
+    IAnimation *animations[] = {&light_rain, &heavy_rain, &countdown, &circle_spin, &scroll_text,
+                                &plasma,     &fire,       &clouds,    &layers4};
+
+    print_header();
+    for (IAnimation *anim : animations) {
+        print_result(run_animation(cube, *anim, frames));
+    }
+    print_result(run_transition(cube, "xfade", circle_spin, heavy_rain, render::TransitionKind::CrossFade, frames));
+    print_result(run_transition(cube, "wipe_x", circle_spin, heavy_rain, render::TransitionKind::WipeX, frames));
+}
+
+} // namespace bench
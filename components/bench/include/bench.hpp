@@ -0,0 +1,46 @@
+#pragma once
+
+#include "common.hpp"
+#include "cube.hpp"
+#include "transition.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+namespace bench {
+
+using anim_common::IAnimation;
+using cube::Cube;
+
+#define K_BENCH_DEFAULT_FRAMES 500
+
+// Outcome of running one animation for a fixed number of frames, back to back.
+struct BenchResult {
+    const char *name = "";
+    uint32_t frames = 0;
+    uint64_t elapsed_us = 0; // step() + show() for all frames
+    uint64_t cycles = 0;     // CPU cycles for the same span (host: TSC ticks)
+    uint64_t bytes = 0;      // bytes pushed to the strips
+    uint32_t worst_us = 0;   // slowest single frame
+    uint32_t budget_ms = 0;  // the animation's frame_period_ms()
+
+    uint32_t fps() const { return elapsed_us ? static_cast<uint32_t>((uint64_t)frames * 1000000 / elapsed_us) : 0; }
+    uint32_t cycles_per_frame() const { return frames ? static_cast<uint32_t>(cycles / frames) : 0; }
+    // True if the slowest frame alone would not fit in the animation's period
+    bool over_budget() const { return worst_us > budget_ms * 1000; }
+};
+
+// init() `anim`, then run `frames` frames of step() + show() with no pacing delay.
+BenchResult run_animation(Cube &cube, IAnimation &anim, uint32_t frames);
+
+// Run `frames` frames of back-to-back transitions of K_RENDER_TRANSITION_FRAMES frames each,
+// alternating between `a` and `b`: the per-frame cost while two animations render at once.
+BenchResult run_transition(Cube &cube, const char *name, IAnimation &a, IAnimation &b, render::TransitionKind kind,
+                           uint32_t frames);
+
+// Benchmark every animation in the firmware on `cube` and print one table row each.
+void run_all(Cube &cube, uint32_t frames = K_BENCH_DEFAULT_FRAMES);
+
+void print_header();
+void print_result(const BenchResult &r);
+
+} // namespace bench
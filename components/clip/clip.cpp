@@ -0,0 +1,149 @@
+#include "clip.hpp"
+#include <stdio.h>
+#include <string.h>
+
+namespace clip {
+
+static inline uint16_t rd16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static inline uint32_t rd32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+esp_err_t ClipDecoder::open(const uint8_t *data, size_t size) {
+    data_ = nullptr;
+    if (data == nullptr || size < K_CLIP_HEADER_BYTES) return ESP_ERR_INVALID_SIZE;
+    if (memcmp(data, K_CLIP_MAGIC, 4) != 0) return ESP_ERR_INVALID_ARG;
+    if (data[4] != K_CLIP_VERSION) return ESP_ERR_INVALID_VERSION;
+
+    ClipInfo info;
+    info.width = data[5];
+    info.height = data[6];
+    info.depth = data[7];
+    info.frame_count = rd32(data + 8);
+    info.frame_ms = rd16(data + 12);
+    info.palette_size = rd16(data + 14);
+    if (info.palette_size == 0 || info.palette_size > K_CLIP_MAX_PALETTE) return ESP_ERR_INVALID_ARG;
+    if (info.frame_count == 0 || info.width == 0 || info.height == 0 || info.depth == 0) return ESP_ERR_INVALID_ARG;
+    const size_t frames_offset = K_CLIP_HEADER_BYTES + (size_t)info.palette_size * 3;
+    if (size < frames_offset + K_CLIP_FRAME_HEADER_BYTES) return ESP_ERR_INVALID_SIZE;
+    // Playback starts and loops at frame 0, so it has to be self-contained
+    if (data[frames_offset] != (uint8_t)FrameType::Key) return ESP_ERR_INVALID_ARG;
+
+    data_ = data;
+    size_ = size;
+    palette_ = data + K_CLIP_HEADER_BYTES;
+    info_ = info;
+    frames_offset_ = frames_offset;
+    rewind();
+    return ESP_OK;
+}
+
+// Run the op list of one frame payload over `dst`, or with `dst` null only check it: next()
+// checks first, so a bad frame is found before any voxel of the target is overwritten
+esp_err_t ClipDecoder::apply(const uint8_t *p, size_t n, bool key, rgb_t *dst, size_t voxels) const {
+    const uint8_t *end = p + n;
+    const rgb_t *pal = reinterpret_cast<const rgb_t *>(palette_);
+    const uint16_t pal_n = info_.palette_size;
+    size_t v = 0;
+    while (p < end) {
+        const Op op = static_cast<Op>(*p >> 6);
+        const size_t count = (size_t)(*p & 0x3F) + 1;
+        ++p;
+        if (v + count > voxels) return ESP_ERR_INVALID_SIZE;
+        switch (op) {
+        case Op::Skip:
+            if (key) return ESP_ERR_INVALID_ARG;
+            break;
+        case Op::Literal:
+            if ((size_t)(end - p) < count) return ESP_ERR_INVALID_SIZE;
+            if (!dst) {
+                for (size_t i = 0; i < count; ++i)
+                    if (p[i] >= pal_n) return ESP_ERR_INVALID_ARG;
+            } else {
+                for (size_t i = 0; i < count; ++i)
+                    dst[v + i] = pal[p[i]];
+            }
+            p += count;
+            break;
+        case Op::Repeat: {
+            if (p == end) return ESP_ERR_INVALID_SIZE;
+            if (*p >= pal_n) return ESP_ERR_INVALID_ARG;
+            const rgb_t c = pal[*p++];
+            if (dst) {
+                for (size_t i = 0; i < count; ++i)
+                    dst[v + i] = c;
+            }
+            break;
+        }
+        default:
+            return ESP_ERR_INVALID_ARG;
+        }
+        v += count;
+    }
+    // A key frame must define every voxel
+    if (key && v != voxels) return ESP_ERR_INVALID_SIZE;
+    return ESP_OK;
+}
+
+esp_err_t ClipDecoder::next(Frame &frame) {
+    if (!data_) return ESP_ERR_INVALID_STATE;
+    if (frame.width() != info_.width || frame.height() != info_.height || frame.depth() != info_.depth)
+        return ESP_ERR_INVALID_SIZE;
+    if (index_ >= info_.frame_count) rewind();
+
+    if (size_ - offset_ < K_CLIP_FRAME_HEADER_BYTES) return ESP_ERR_INVALID_SIZE;
+    const uint8_t *rec = data_ + offset_;
+    const uint8_t type = rec[0];
+    const uint32_t n = rd32(rec + 1);
+    if (type > (uint8_t)FrameType::Delta) return ESP_ERR_INVALID_ARG;
+    if (size_ - offset_ - K_CLIP_FRAME_HEADER_BYTES < n) return ESP_ERR_INVALID_SIZE;
+
+    const uint8_t *payload = rec + K_CLIP_FRAME_HEADER_BYTES;
+    const bool key = type == (uint8_t)FrameType::Key;
+    esp_err_t err = apply(payload, n, key, nullptr, frame.voxels());
+    if (err != ESP_OK) return err;
+    apply(payload, n, key, frame.data(), frame.voxels());
+    offset_ += K_CLIP_FRAME_HEADER_BYTES + n;
+    ++index_;
+    return ESP_OK;
+}
+
+void ClipDecoder::prefetch() const {
+    if (!data_) return;
+    size_t offset = index_ < info_.frame_count ? offset_ : frames_offset_;
+    if (size_ - offset < K_CLIP_FRAME_HEADER_BYTES) return;
+    size_t end = offset + K_CLIP_FRAME_HEADER_BYTES + rd32(data_ + offset + 1);
+    if (end > size_) end = size_;
+    const volatile uint8_t *p = data_;
+    for (; offset < end; offset += K_CLIP_PREFETCH_STRIDE)
+        (void)p[offset];
+    (void)p[end - 1];
+}
+
+void ClipAnim::init(Frame &target) {
+    ok_ = false;
+    target.clear();
+    esp_err_t err = dec_.is_open() ? ESP_OK : dec_.open(data_, size_);
+    if (err == ESP_OK && (target.width() != dec_.info().width || target.height() != dec_.info().height ||
+                          target.depth() != dec_.info().depth)) {
+        err = ESP_ERR_INVALID_SIZE;
+    }
+    if (err != ESP_OK) {
+        printf("clip %s: cannot play: err=0x%x\n", name_, (unsigned)err);
+        return;
+    }
+    dec_.rewind();
+    ok_ = true;
+}
+
+void ClipAnim::step(Frame &target, uint32_t /*dt_ms*/) {
+    if (!ok_) return;
+    esp_err_t err = dec_.next(target);
+    if (err != ESP_OK) {
+        // Corrupt data: stop on the last good frame (next() wrote nothing) rather than show garbage
+        printf("clip %s: frame %lu: err=0x%x\n", name_, (unsigned long)dec_.position(), (unsigned)err);
+        ok_ = false;
+    }
+}
+
+} // namespace clip
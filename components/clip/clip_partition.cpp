@@ -0,0 +1,50 @@
+#include "clip_partition.hpp"
+#include "esp_log.h"
+
+namespace clip {
+
+static const char *TAG = "clip";
+
+esp_err_t PartitionClip::map(const char *label) {
+    unmap();
+    const esp_partition_t *part = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, static_cast<esp_partition_subtype_t>(K_CLIP_PARTITION_SUBTYPE), label);
+    if (!part) return ESP_ERR_NOT_FOUND;
+
+    // The whole partition: ClipDecoder checks every frame record against the mapped size as it
+    // reaches it, so nothing has to walk the clip up front to find where it ends
+    const void *ptr = nullptr;
+    esp_err_t err = esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &ptr, &handle_);
+    if (err != ESP_OK) return err;
+    data_ = static_cast<const uint8_t *>(ptr);
+    size_ = part->size;
+
+    // An erased or foreign partition is not a clip
+    ClipDecoder probe;
+    err = probe.open(data_, size_);
+    if (err != ESP_OK) {
+        unmap();
+        return err;
+    }
+    ESP_LOGI(TAG, "mapped %lu frame clip from partition '%s'", (unsigned long)probe.info().frame_count, label);
+    return ESP_OK;
+}
+
+void PartitionClip::unmap() {
+    if (!data_) return;
+    esp_partition_munmap(handle_);
+    data_ = nullptr;
+    size_ = 0;
+}
+
+void PartitionClipAnim::init(Frame &target) {
+    if (!part_.data() && !tried_) {
+        tried_ = true;
+        const esp_err_t err = part_.map(label_);
+        if (err != ESP_OK) ESP_LOGW(TAG, "partition '%s': no clip mapped: %s", label_, esp_err_to_name(err));
+        set_data(part_.data(), part_.size());
+    }
+    ClipAnim::init(target);
+}
+
+} // namespace clip
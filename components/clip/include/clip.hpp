@@ -0,0 +1,120 @@
+#pragma once
+
+#include "common.hpp"
+#include "esp_err.h"
+#include "frame.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+// Precomputed animations ("clips"): a palettised, run-length coded frame stream that is
+// decoded straight into the cube's back buffer, so playback costs a small constant per
+// frame however expensive the effect was to compute.
+//
+// Layout (little endian):
+//   0  "AUCL"
+//   4  u8  version (K_CLIP_VERSION)
+//   5  u8  width, u8 height, u8 depth
+//   8  u32 frame count
+//   12 u16 frame period, ms
+//   14 u16 palette entries (1..256), followed by that many r, g, b triplets
+//   then per frame: u8 type (FrameType), u32 payload bytes, payload
+//
+// A payload is a list of ops over the voxels in Frame order; each op byte holds the Op in
+// its top two bits and count - 1 (1..64 voxels) in the low six. Skip leaves voxels as they
+// are, Literal is followed by `count` palette indices, Repeat by one index for all of them.
+// Key frames cover every voxel without Skip, so playback can start or loop at any of them;
+// delta frames only code the voxels that changed since the previous frame.
+namespace clip {
+
+using anim_common::IAnimation;
+using cube::Frame;
+using utils::rgb_t;
+
+#define K_CLIP_MAGIC "AUCL"
+#define K_CLIP_VERSION 1
+#define K_CLIP_HEADER_BYTES 16
+#define K_CLIP_FRAME_HEADER_BYTES 5
+#define K_CLIP_MAX_PALETTE 256
+#define K_CLIP_MAX_RUN 64
+// Stride of the reads prefetch() uses to pull a frame into the flash cache (its line size)
+#define K_CLIP_PREFETCH_STRIDE 32
+
+enum class FrameType : uint8_t { Key = 0, Delta = 1 };
+enum class Op : uint8_t { Skip = 0, Literal = 1, Repeat = 2 };
+
+struct ClipInfo {
+    uint8_t width = 0;
+    uint8_t height = 0;
+    uint8_t depth = 0;
+    uint32_t frame_count = 0;
+    uint16_t frame_ms = 0;
+    uint16_t palette_size = 0;
+};
+
+// Decodes a clip held in memory (embedded binary or a memory-mapped flash partition) one
+// frame at a time; it keeps no frame state of its own, deltas apply to the target frame.
+class ClipDecoder {
+  public:
+    // Check the header and palette; the data must stay valid while the decoder is used.
+    esp_err_t open(const uint8_t *data, size_t size);
+    const ClipInfo &info() const { return info_; }
+    bool is_open() const { return data_ != nullptr; }
+
+    // Decode the next frame into `frame`, which must have the clip's geometry and hold the
+    // previously decoded frame. After the last frame playback wraps to the first. A frame that
+    // fails to decode leaves `frame` untouched.
+    esp_err_t next(Frame &frame);
+    void rewind() {
+        offset_ = frames_offset_;
+        index_ = 0;
+    }
+    // Index of the frame next() decodes
+    uint32_t position() const { return index_; }
+    // Touch the next frame's record once per cache line, so that when the clip is mapped from
+    // flash the cache misses happen now rather than inside next()
+    void prefetch() const;
+
+  private:
+    esp_err_t apply(const uint8_t *p, size_t n, bool key, rgb_t *dst, size_t voxels) const;
+
+    const uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+    const uint8_t *palette_ = nullptr; // palette_size r, g, b triplets
+    ClipInfo info_;
+    size_t frames_offset_ = 0;
+    size_t offset_ = 0; // next frame record
+    uint32_t index_ = 0;
+};
+
+// Plays a clip as an animation, looping, at the clip's own frame period.
+class ClipAnim : public IAnimation {
+  public:
+    ClipAnim(const char *name, const uint8_t *data, size_t size) : name_(name), data_(data), size_(size) {}
+
+    void init(Frame &target) override;
+    void step(Frame &target, uint32_t dt_ms) override;
+    uint32_t frame_period_ms() const override {
+        return dec_.info().frame_ms ? dec_.info().frame_ms : K_DEFAULT_FRAME_MS;
+    }
+    const char *name() const override { return name_; }
+    void prefetch() override {
+        if (ok_) dec_.prefetch();
+    }
+
+  protected:
+    // Replace the clip data; it is opened again at the next init()
+    void set_data(const uint8_t *data, size_t size) {
+        data_ = data;
+        size_ = size;
+        dec_ = ClipDecoder();
+    }
+
+  private:
+    const char *name_;
+    const uint8_t *data_;
+    size_t size_;
+    ClipDecoder dec_;
+    bool ok_ = false; // the clip opened and matches the target
+};
+
+} // namespace clip
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "clip.hpp"
+#include "esp_partition.h"
+
+// Clips stored in a data partition (see partitions.csv) and read in place through the flash
+// cache: mapping costs no heap and no RAM beyond the cache itself.
+namespace clip {
+
+// Data subtype of clip partitions, in the range ESP-IDF leaves to applications
+#define K_CLIP_PARTITION_SUBTYPE 0x40
+#define K_CLIP_PARTITION_LABEL "clips"
+
+// One clip written at offset 0 of a partition, mapped into the data address space.
+class PartitionClip {
+  public:
+    PartitionClip() = default;
+    PartitionClip(const PartitionClip &) = delete;
+    PartitionClip &operator=(const PartitionClip &) = delete;
+    ~PartitionClip() { unmap(); }
+
+    // Find the partition and map all of it; the clip's end is found by the decoder as it plays.
+    // Fails with ESP_ERR_NOT_FOUND for a missing partition, or a ClipDecoder error if the
+    // partition does not start with a clip header.
+    esp_err_t map(const char *label = K_CLIP_PARTITION_LABEL);
+    void unmap();
+
+    const uint8_t *data() const { return data_; }
+    size_t size() const { return size_; }
+
+  private:
+    const uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+    esp_partition_mmap_handle_t handle_ = 0;
+};
+
+// ClipAnim over a partition, mapped on first init() and kept mapped afterwards. A partition
+// that failed to map is not tried again; it stays dark.
+class PartitionClipAnim : public ClipAnim {
+  public:
+    explicit PartitionClipAnim(const char *name, const char *label = K_CLIP_PARTITION_LABEL)
+        : ClipAnim(name, nullptr, 0), label_(label) {}
+
+    void init(Frame &target) override;
+
+  private:
+    const char *label_;
+    PartitionClip part_;
+    bool tried_ = false;
+};
+
+} // namespace clip
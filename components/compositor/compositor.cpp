@@ -0,0 +1,46 @@
+#include "compositor.hpp"
+#include <assert.h>
+
+namespace compositor {
+
+Compositor::Compositor(const char *name, const Layer *layers, size_t count)
+    : name_(name), count_(count < K_COMPOSITOR_MAX_LAYERS ? count : K_COMPOSITOR_MAX_LAYERS) {
+    assert(count <= K_COMPOSITOR_MAX_LAYERS);
+    for (size_t i = 0; i < count_; ++i)
+        layers_[i] = layers[i];
+}
+
+void Compositor::init(Frame &target) {
+    // Layer buffers follow the target's geometry; resize() only reallocates when it grows
+    for (size_t i = 0; i < count_; ++i) {
+        frames_[i].resize(target.width(), target.height(), target.depth());
+        layers_[i].anim->init(frames_[i]);
+    }
+    target.clear();
+}
+
+void Compositor::step(Frame &target, uint32_t dt_ms) {
+    BlendLayer blend[K_COMPOSITOR_MAX_LAYERS];
+    for (size_t i = 0; i < count_; ++i) {
+        layers_[i].anim->step(frames_[i], dt_ms);
+        blend[i] = BlendLayer{reinterpret_cast<const uint8_t *>(frames_[i].data()), layers_[i].mode,
+                              layers_[i].opacity};
+    }
+    target.composite(blend, count_);
+}
+
+uint32_t Compositor::frame_period_ms() const {
+    uint32_t period = count_ ? layers_[0].anim->frame_period_ms() : K_DEFAULT_FRAME_MS;
+    for (size_t i = 1; i < count_; ++i) {
+        const uint32_t p = layers_[i].anim->frame_period_ms();
+        if (p < period) period = p;
+    }
+    return period;
+}
+
+void Compositor::prefetch() {
+    for (size_t i = 0; i < count_; ++i)
+        layers_[i].anim->prefetch();
+}
+
+} // namespace compositor
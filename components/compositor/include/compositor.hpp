@@ -0,0 +1,53 @@
+#pragma once
+
+#include "common.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+// Several animations at once: each renders into its own off-screen layer, and the layers are
+// blended into the target in one pass (Frame::composite).
+namespace compositor {
+
+using anim_common::IAnimation;
+using cube::BlendLayer;
+using cube::BlendMode;
+using cube::Frame;
+
+#define K_COMPOSITOR_MAX_LAYERS 4
+
+struct Layer {
+    IAnimation *anim;
+    BlendMode mode = BlendMode::Alpha;
+    uint8_t opacity = 255;
+};
+
+// Layers are listed bottom first. An animation instance belongs to one layer only: it keeps
+// state between steps, so sharing it would step it twice per frame. The compositor steps
+// every layer each frame and runs at the fastest layer's rate.
+class Compositor : public IAnimation {
+  public:
+    Compositor(const char *name, const Layer *layers, size_t count);
+
+    void init(Frame &target) override;
+    void step(Frame &target, uint32_t dt_ms) override;
+    uint32_t frame_period_ms() const override;
+    const char *name() const override { return name_; }
+    void prefetch() override;
+
+    size_t layer_count() const { return count_; }
+    // Thread-unsafe: call from the render task or while the compositor is not playing
+    void set_opacity(size_t layer, uint8_t opacity) {
+        if (layer < count_) layers_[layer].opacity = opacity;
+    }
+    void set_mode(size_t layer, BlendMode mode) {
+        if (layer < count_) layers_[layer].mode = mode;
+    }
+
+  private:
+    const char *name_;
+    Layer layers_[K_COMPOSITOR_MAX_LAYERS];
+    Frame frames_[K_COMPOSITOR_MAX_LAYERS];
+    size_t count_;
+};
+
+} // namespace compositor
@@ -0,0 +1,149 @@
+#include "chain_output.hpp"
+#include "strip.hpp"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace cube {
+
+ChainOutput::ChainOutput() { rebuild_lut(); }
+
+ChainOutput::~ChainOutput() { release(); }
+
+ChainOutput::ChainOutput(ChainOutput &&other) noexcept { *this = static_cast<ChainOutput &&>(other); }
+
+ChainOutput &ChainOutput::operator=(ChainOutput &&other) noexcept {
+    if (this != &other) {
+        release();
+        backend_ = other.backend_;
+        count_ = other.count_;
+        ops_ = other.ops_;
+        set_pixel_ = other.set_pixel_;
+        memcpy(handles_, other.handles_, sizeof(handles_));
+        memcpy(chain_leds_, other.chain_leds_, sizeof(chain_leds_));
+        in_flight_ = other.in_flight_;
+        bytes_sent_ = other.bytes_sent_;
+        global_brightness_ = other.global_brightness_;
+        gamma_ = other.gamma_;
+        white_balance_ = other.white_balance_;
+        memcpy(lut_, other.lut_, sizeof(lut_));
+
+        // The moved-from object keeps no strips
+        memset(other.handles_, 0, sizeof(other.handles_));
+        other.count_ = 0;
+        other.in_flight_ = false;
+    }
+    return *this;
+}
+
+void ChainOutput::release() {
+    wait_idle();
+    for (size_t i = 0; i < count_; ++i) {
+        if (handles_[i]) {
+            ops_->del(handles_[i]);
+            handles_[i] = nullptr;
+        }
+    }
+    count_ = 0;
+}
+
+esp_err_t ChainOutput::init(Backend backend, const PanelChainConfig *chains, size_t count, uint32_t leds_per_panel) {
+    if (count_ != 0) return ESP_ERR_INVALID_STATE;
+    if (count == 0 || count > K_MAX_CHAINS) return ESP_ERR_INVALID_ARG;
+    backend_ = backend;
+
+    // One strip device per chain (RMT channel, SPI bus or RAM)
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t leds = chains[i].panels * leds_per_panel;
+        // Mixed: RMT channels first, then the SPI buses
+        Backend chain_backend = backend;
+        uint32_t spi_bus = i;
+        if (backend == Backend::Mixed) {
+            chain_backend = (i < K_MAX_RMT_CHAINS) ? Backend::RMT : Backend::SPI;
+            spi_bus = (i < K_MAX_RMT_CHAINS) ? 0 : i - K_MAX_RMT_CHAINS;
+        }
+        esp_err_t err = ESP_ERR_NOT_SUPPORTED;
+        if (chain_backend == Backend::Sim) {
+            err = sim_chain_new(leds, &handles_[i], &ops_);
+        } else {
+#if CUBE_HAS_LED_STRIP
+            err = led_strip_chain_new(chain_backend, chains[i].pin, leds, spi_bus, &handles_[i], &ops_);
+#else
+            (void)spi_bus;
+#endif
+        }
+        if (err != ESP_OK) {
+            printf("Cube: creating %s strip failed on chain %d: err=0x%x\n",
+                   chain_backend == Backend::SPI ? "SPI" : (chain_backend == Backend::RMT ? "RMT" : "Sim"), (int)i,
+                   (unsigned)err);
+            release();
+            return err;
+        }
+        chain_leds_[i] = leds;
+        count_ = i + 1;
+    }
+    set_pixel_ = ops_->set_pixel;
+    return ESP_OK;
+}
+
+void ChainOutput::set_global_brightness(float factor) {
+    if (factor < 0.0f) factor = 0.0f;
+    if (factor > 1.0f) factor = 1.0f;
+    global_brightness_ = factor;
+    rebuild_lut();
+}
+
+void ChainOutput::set_gamma(float gamma) {
+    if (gamma < 0.1f) gamma = 0.1f;
+    gamma_ = gamma;
+    rebuild_lut();
+}
+
+void ChainOutput::set_white_balance(rgb_t wb) {
+    white_balance_ = wb;
+    rebuild_lut();
+}
+
+// Fold gamma, white balance and global brightness into one table per channel.
+// This is the only place the colour pipeline touches floating point.
+void ChainOutput::rebuild_lut() {
+    const uint8_t wb[3] = {white_balance_.r, white_balance_.g, white_balance_.b};
+    for (int c = 0; c < 3; ++c) {
+        const float gain = global_brightness_ * (wb[c] / 255.0f) * 255.0f;
+        for (int i = 0; i < 256; ++i) {
+            const float lin = (gamma_ == 1.0f) ? (i / 255.0f) : powf(i / 255.0f, gamma_);
+            lut_[c][i] = static_cast<uint8_t>(lin * gain + 0.5f);
+        }
+    }
+}
+
+esp_err_t ChainOutput::refresh(uint32_t chain_mask) {
+    // Kick every chain before waiting on any of them so they transmit in parallel
+    for (size_t ci = 0; ci < count_; ++ci) {
+        if (!(chain_mask & (1u << ci))) continue;
+        void *h = handles_[ci];
+        if (!h) return ESP_ERR_INVALID_STATE;
+        esp_err_t err = ops_->refresh_async(h);
+        if (err != ESP_OK) return err;
+        in_flight_ = true;
+        bytes_sent_ += chain_leds_[ci] * 3;
+    }
+    return ESP_OK;
+}
+
+esp_err_t ChainOutput::wait_idle() {
+    if (!in_flight_) return ESP_OK;
+    // Wait on every chain even after an error, so none is left transmitting; the first error
+    // is reported and the next call waits again
+    esp_err_t first_err = ESP_OK;
+    for (size_t ci = 0; ci < count_; ++ci) {
+        void *h = handles_[ci];
+        if (!h) continue;
+        esp_err_t err = ops_->wait_done(h);
+        if (err != ESP_OK && first_err == ESP_OK) first_err = err;
+    }
+    if (first_err == ESP_OK) in_flight_ = false;
+    return first_err;
+}
+
+} // namespace cube
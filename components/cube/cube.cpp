@@ -1,15 +1,16 @@
-// Cube implementation with RMT backend only for now
+// Cube implementation; strips and the colour stage are handled by ChainOutput
 #include "cube.hpp"
-#include "led_strip.h"
-#include "soc/soc_caps.h"
 #include <assert.h>
+#include <stdio.h>
 #include <string.h>
 
 namespace cube {
 
-Cube::Cube(const CubeCreateArgs &args)
-    : backend_(args.backend), chain_count_(args.chain_count), panels_width_(args.panels_width),
-      panels_height_(args.panels_height) {
+Cube::Cube(const CubeCreateArgs &args) : Cube(args, &Cube::encode_rows) {}
+
+Cube::Cube(const CubeCreateArgs &args, EncodeFn encode)
+    : chain_count_(args.chain_count), panels_width_(args.panels_width), panels_height_(args.panels_height),
+      encode_(encode) {
     assert(validate(args) && "invalid CubeCreateArgs");
     uint32_t faces = 0;
     for (size_t i = 0; i < chain_count_; ++i) {
@@ -18,161 +19,103 @@ Cube::Cube(const CubeCreateArgs &args)
     }
     total_faces_ = faces;
     pixels_per_face_ = panels_width_ * panels_height_;
+    buf_.resize(panels_width_, panels_height_, total_faces_);
+    front_.resize(panels_width_, panels_height_, total_faces_);
+    build_led_map();
 
-    // Initialize backend (RMT only)
-    if (backend_ == Backend::RMT) {
-        handle_count_ = chain_count_;
-        uint32_t faces_base = 0;
-        for (size_t i = 0; i < chain_count_; ++i) {
-            const auto &ch = chains_[i];
-            const uint32_t leds = ch.panels * panels_width_ * panels_height_;
-            chain_leds_[i] = leds;
-
-            led_strip_config_t sc = {};
-            sc.strip_gpio_num = ch.pin;
-            sc.max_leds = leds;
-            sc.led_model = LED_MODEL_WS2812;
-            sc.color_component_format = LED_STRIP_COLOR_COMPONENT_FMT_GRB;
-            sc.flags.invert_out = false;
-
-            led_strip_rmt_config_t rc = {};
-            rc.clk_src = RMT_CLK_SRC_DEFAULT;
-            rc.resolution_hz = RMT_HZ;
-            rc.mem_block_symbols = SOC_RMT_MEM_WORDS_PER_CHANNEL; // default
-            rc.flags.with_dma = 0;                                // C6: no RMT-DMA
-
-            led_strip_handle_t handle;
-            esp_err_t err = led_strip_new_rmt_device(&sc, &rc, &handle);
-            if (err != ESP_OK) {
-                printf("Cube: led_strip_new_rmt_device failed on chain %d: err=0x%x\n", (int)i, (unsigned)err);
-                assert(false && "failed to create RMT led strip");
-            }
-            handles_[i] = handle;
-            (void)faces_base; // reserved if we later track per-chain face offsets
-            faces_base += ch.panels;
-        }
-    }
-}
-
-Cube::Cube(Cube &&other) noexcept
-    : backend_(other.backend_), chain_count_(other.chain_count_), total_faces_(other.total_faces_) {
-    for (size_t i = 0; i < other.chain_count_; ++i)
-        chains_[i] = other.chains_[i];
-    other.chain_count_ = 0;
-    other.total_faces_ = 0;
-}
-
-Cube &Cube::operator=(Cube &&other) noexcept {
-    if (this != &other) {
-        backend_ = other.backend_;
-        chain_count_ = other.chain_count_;
-        for (size_t i = 0; i < other.chain_count_; ++i)
-            chains_[i] = other.chains_[i];
-        total_faces_ = other.total_faces_;
-        other.chain_count_ = 0;
-        other.total_faces_ = 0;
-    }
-    return *this;
-}
-
-Cube::~Cube() {
-    if (backend_ == Backend::RMT) {
-        for (size_t i = 0; i < handle_count_; ++i) {
-            if (handles_[i]) {
-                led_strip_del((led_strip_handle_t)handles_[i]);
-                handles_[i] = nullptr;
-            }
-        }
-    }
+    esp_err_t err = out_.init(args.backend, chains_, chain_count_, pixels_per_face_);
+    if (err != ESP_OK) assert(false && "failed to create led strip");
 }
 
-bool Cube::map_face_to_chain(uint32_t z, size_t &chain_idx, uint32_t &faces_before) const {
-    if (z >= total_faces_) return false;
-    uint32_t acc = 0;
-    for (size_t i = 0; i < chain_count_; ++i) {
-        const uint32_t next = acc + chains_[i].panels;
-        if (z < next) {
-            chain_idx = i;
-            faces_before = acc;
-            return true;
-        }
-        acc = next;
-    }
-    return false;
-}
+Cube::~Cube() = default;
 
-inline uint32_t Cube::serpentine_index(uint32_t x, uint32_t y, bool first_row_backwards) {
+uint32_t Cube::serpentine_index(uint32_t x, uint32_t y, bool first_row_backwards) const {
     const bool row_back = (y % 2 == 0) ? first_row_backwards : !first_row_backwards;
     const uint32_t col = row_back ? (panels_width_ - 1 - x) : x;
     return y * panels_width_ + col;
 }
 
-esp_err_t Cube::poke(uint32_t x, uint32_t y, uint32_t z, rgb_t v) {
-    if (z >= total_faces_ || y >= panels_height_ || x >= panels_width_) return ESP_ERR_INVALID_ARG;
-
-    size_t ci;
-    uint32_t faces_before;
-    if (!map_face_to_chain(z, ci, faces_before)) return ESP_ERR_INVALID_STATE;
-
-    auto h = (led_strip_handle_t)handles_[ci];
-    if (!h) return ESP_ERR_INVALID_STATE;
-
-    const uint32_t local_face = z - faces_before;
-    const uint32_t base = local_face * pixels_per_face_;
-    uint32_t idx = serpentine_index(x, y, chains_[ci].first_row_backwards);
-
-    // Even faces (0, 2...) are filled normally.
-    // Odd faces (1, 3...) are filled in reverse order because the chain
-    // snakes from the end of the previous face into the "end" of the current face.
-    if (local_face % 2 != 0) {
-        idx = (pixels_per_face_ - 1) - idx;
-    }
-
-    const uint32_t led = base + idx;
-
-    // Apply global brightness scaling here
-    uint8_t r = v.r;
-    uint8_t g = v.g;
-    uint8_t b = v.b;
-    if (global_brightness_ >= 0.0f && global_brightness_ < 1.0f) {
-        float f = global_brightness_;
-        r = static_cast<uint8_t>(static_cast<float>(r) * f);
-        g = static_cast<uint8_t>(static_cast<float>(g) * f);
-        b = static_cast<uint8_t>(static_cast<float>(b) * f);
+// Resolve every voxel to its (chain, LED) address once, so show() never walks the
+// chain layout or branches on row/face parity.
+void Cube::build_led_map() {
+    led_map_.reset(new LedAddr[total_leds()]);
+    uint32_t z = 0;
+    for (size_t ci = 0; ci < chain_count_; ++ci) {
+        const bool first_row_backwards = chains_[ci].first_row_backwards;
+        for (uint32_t local_face = 0; local_face < chains_[ci].panels; ++local_face, ++z) {
+            face_chain_[z] = static_cast<uint8_t>(ci);
+            const uint32_t base = local_face * pixels_per_face_;
+            for (uint32_t y = 0; y < panels_height_; ++y) {
+                for (uint32_t x = 0; x < panels_width_; ++x) {
+                    uint32_t idx = serpentine_index(x, y, first_row_backwards);
+
+                    // Even faces (0, 2...) are filled normally.
+                    // Odd faces (1, 3...) are filled in reverse order because the chain
+                    // snakes from the end of the previous face into the "end" of the current face.
+                    if (local_face % 2 != 0) {
+                        idx = (pixels_per_face_ - 1) - idx;
+                    }
+
+                    led_map_[buf_.index(x, y, z)] =
+                        LedAddr{static_cast<uint16_t>(base + idx), static_cast<uint8_t>(ci)};
+                }
+            }
+        }
     }
-
-    esp_err_t err = led_strip_set_pixel(h, led, r, g, b);
-    if (err != ESP_OK) return err;
-
-    chain_dirty_[ci] = true;
-    return ESP_OK;
 }
 
 esp_err_t Cube::clear() {
-    if (backend_ != Backend::RMT) return ESP_ERR_NOT_SUPPORTED;
-
-    for (size_t ci = 0; ci < handle_count_; ++ci) {
-        auto h = (led_strip_handle_t)handles_[ci];
-        if (!h) return ESP_ERR_INVALID_STATE;
+    buf_.clear();
+    dirty_ = true;
+    return show();
+}
 
-        esp_err_t err = led_strip_clear(h);
-        if (err != ESP_OK) return err;
+esp_err_t Cube::show() {
+    CUBE_PROF(last_timing_ = FrameTiming{});
+    if (!dirty_) return ESP_OK;
 
-        chain_dirty_[ci] = true; // mark so show() will refresh
+    // The strip memory is what the driver is transmitting from, so the previous frame must be
+    // out before it is overwritten. Rendering into buf_ meanwhile is what overlaps with the wire.
+    CUBE_PROF(const int64_t t_wait = CUBE_PROF_NOW());
+    esp_err_t err = out_.wait_idle();
+    if (err != ESP_OK) return err;
+    CUBE_PROF(const int64_t t_encode = CUBE_PROF_NOW());
+
+    // The back buffer keeps its contents so incremental effects (fades, trails) continue
+    // from what is on screen; the encoder brings the front buffer's changed rows up to date.
+    uint32_t changed_chains = 0;
+    err = encode_(*this, changed_chains);
+    CUBE_PROF(last_timing_.wait_us = static_cast<uint32_t>(t_encode - t_wait));
+    CUBE_PROF(last_timing_.encode_us = static_cast<uint32_t>(CUBE_PROF_NOW() - t_encode));
+    if (err == ESP_OK && changed_chains) err = out_.refresh(changed_chains);
+    if (err != ESP_OK) {
+        // The front buffer may now hold rows that never reached the strips
+        full_encode_ = true;
+        return err;
     }
-    return show();
+    // No changed row means the frame is byte-identical to what is latched: nothing was sent
+    dirty_ = false;
+    full_encode_ = false;
+    return ESP_OK;
 }
 
-esp_err_t Cube::show() {
-    if (backend_ != Backend::RMT) return ESP_ERR_NOT_SUPPORTED;
-
-    for (size_t ci = 0; ci < handle_count_; ++ci) {
-        if (!chain_dirty_[ci]) continue;
-        auto h = (led_strip_handle_t)handles_[ci];
-        if (!h) return ESP_ERR_INVALID_STATE;
-        esp_err_t err = led_strip_refresh(h);
-        if (err != ESP_OK) return err;
-        chain_dirty_[ci] = false;
+esp_err_t Cube::encode_rows(Cube &cube, uint32_t &changed_chains) {
+    const uint32_t W = cube.panels_width_;
+    const size_t row_bytes = W * sizeof(rgb_t);
+    const rgb_t *back = cube.buf_.data();
+    rgb_t *sent = cube.front_.data();
+    size_t first = 0;
+    for (uint32_t z = 0; z < cube.total_faces_; ++z) {
+        for (uint32_t y = 0; y < cube.panels_height_; ++y, first += W) {
+            if (!cube.full_encode_ && memcmp(back + first, sent + first, row_bytes) == 0) continue;
+            changed_chains |= 1u << cube.face_chain_[z];
+            for (size_t i = first; i < first + W; ++i) {
+                const LedAddr a = cube.led_map_[i];
+                esp_err_t err = cube.out_.set_pixel(a.chain, a.led, back[i]);
+                if (err != ESP_OK) return err;
+            }
+            memcpy(sent + first, back + first, row_bytes);
+        }
     }
     return ESP_OK;
 }
@@ -184,7 +127,7 @@ void Cube::debug_dump() const {
         for (uint32_t y = 0; y < panels_height_; ++y) {
             printf("  y=%lu: ", (unsigned long)y);
             for (uint32_t x = 0; x < panels_width_; ++x) {
-                const rgb_t &c = buf_[z][y][x];
+                const rgb_t &c = buf_.at(x, y, z);
                 // print as hex for compactness
                 printf("(%02x,%02x,%02x) ", c.r, c.g, c.b);
             }
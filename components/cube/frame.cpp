@@ -0,0 +1,219 @@
+// Whole-frame operations on packed RGB bytes, four channels per 32-bit word.
+// The voxel data is treated as one byte stream: word k holds channel bytes 4k..4k+3
+// regardless of which voxel they belong to, which is fine because every operation
+// here treats all channels alike. Leftover bytes (< 4) go through the scalar path.
+#include "frame.hpp"
+#include <string.h>
+
+namespace cube {
+
+// Per-byte lanes: even bytes in one mask, odd bytes shifted down into the same mask
+#define SWAR_EVEN 0x00FF00FFu
+#define SWAR_MSB 0x80808080u
+#define SWAR_LOW7 0x7F7F7F7Fu
+
+static inline uint32_t load32(const uint8_t *p) {
+    uint32_t w;
+    memcpy(&w, p, 4);
+    return w;
+}
+
+static inline void store32(uint8_t *p, uint32_t w) { memcpy(p, &w, 4); }
+
+// f in [0, 256]: each byte becomes (byte * f) >> 8. 16-bit lanes hold 255 * 256 without overflow.
+static inline uint32_t swar_scale(uint32_t w, uint32_t f) {
+    const uint32_t even = (((w & SWAR_EVEN) * f) >> 8) & SWAR_EVEN;
+    const uint32_t odd = (((w >> 8) & SWAR_EVEN) * f) & ~SWAR_EVEN;
+    return even | odd;
+}
+
+// Per-byte a + (b - a) * f / 256 as (a * (256 - f) + b * f) >> 8, f in [0, 256]
+static inline uint32_t swar_lerp(uint32_t a, uint32_t b, uint32_t f) {
+    const uint32_t inv = 256 - f;
+    const uint32_t even = (((a & SWAR_EVEN) * inv + (b & SWAR_EVEN) * f) >> 8) & SWAR_EVEN;
+    const uint32_t odd = (((a >> 8) & SWAR_EVEN) * inv + ((b >> 8) & SWAR_EVEN) * f) & ~SWAR_EVEN;
+    return even | odd;
+}
+
+// Per-byte saturating add: add the low 7 bits without cross-byte carries (bit 7 of each byte
+// then holds the carry into it), derive the carry out of bit 7, restore bit 7, and force
+// bytes that carried out to 0xFF.
+static inline uint32_t swar_add_sat(uint32_t a, uint32_t b) {
+    uint32_t sum = (a & SWAR_LOW7) + (b & SWAR_LOW7);
+    const uint32_t carry = ((a & b) | ((a | b) & sum)) & SWAR_MSB;
+    sum ^= (a ^ b) & SWAR_MSB;
+    return sum | ((carry >> 7) * 0xFFu);
+}
+
+// Per-byte max: in 16-bit lanes, 0x100 + a - b keeps bit 8 set exactly when a >= b
+static inline uint32_t swar_max(uint32_t a, uint32_t b) {
+    uint32_t out = 0;
+    for (int shift = 0; shift <= 8; shift += 8) {
+        const uint32_t la = (a >> shift) & SWAR_EVEN, lb = (b >> shift) & SWAR_EVEN;
+        const uint32_t ge = ((((la | 0x01000100u) - lb) >> 8) & 0x00010001u) * 0xFFu;
+        out |= ((la & ge) | (lb & ~ge)) << shift;
+    }
+    return out;
+}
+
+// Per-byte a * b / 255, exact at 0 and 255; channel products need a multiply each
+static inline uint32_t swar_mul(uint32_t a, uint32_t b) {
+    uint32_t out = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        const uint32_t p = ((a >> shift) & 0xFF) * ((b >> shift) & 0xFF);
+        out |= ((p + 255) >> 8) << shift;
+    }
+    return out;
+}
+
+// fp / 255 approximated as (fp + 1) / 256, matching utils::scale8()
+static inline uint32_t fade_factor(uint8_t fp) { return (uint32_t)fp + 1; }
+
+namespace frame_ops {
+
+void fill(rgb_t *dst, size_t voxels, rgb_t c) {
+    if (c.r == c.g && c.g == c.b) {
+        memset(dst, c.r, voxels * sizeof(rgb_t));
+        return;
+    }
+    for (size_t i = 0; i < voxels; ++i)
+        dst[i] = c;
+}
+
+void fade(uint8_t *p, size_t n, uint8_t fp) {
+    if (fp == 255) return;
+    const uint32_t f = fade_factor(fp);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        store32(p + i, swar_scale(load32(p + i), f));
+    for (; i < n; ++i)
+        p[i] = static_cast<uint8_t>((p[i] * f) >> 8);
+}
+
+void blend(uint8_t *a, const uint8_t *b, size_t n, uint8_t alpha) {
+    if (alpha == 0) return;
+    if (alpha == 255) {
+        memcpy(a, b, n);
+        return;
+    }
+    // Map 0..255 onto 0..256 so full alpha reaches `b` exactly
+    const uint32_t f = (uint32_t)alpha + (alpha >> 7);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        store32(a + i, swar_lerp(load32(a + i), load32(b + i), f));
+    for (; i < n; ++i)
+        a[i] = static_cast<uint8_t>((a[i] * (256 - f) + b[i] * f) >> 8);
+}
+
+void add_saturate(uint8_t *a, const uint8_t *b, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        store32(a + i, swar_add_sat(load32(a + i), load32(b + i)));
+    for (; i < n; ++i) {
+        const uint32_t s = a[i] + b[i];
+        a[i] = static_cast<uint8_t>(s > 255 ? 255 : s);
+    }
+}
+
+// One word of `l` applied over `d`; `f` is the opacity mapped onto 0..256
+static inline uint32_t composite_word(uint32_t d, uint32_t s, const BlendLayer &l, uint32_t f) {
+    uint32_t r;
+    switch (l.mode) {
+    case BlendMode::Add:
+        r = swar_add_sat(d, s);
+        break;
+    case BlendMode::Max:
+        r = swar_max(d, s);
+        break;
+    case BlendMode::Multiply:
+        r = swar_mul(d, s);
+        break;
+    case BlendMode::Alpha:
+    default:
+        r = s;
+        break;
+    }
+    return f == 256 ? r : swar_lerp(d, r, f);
+}
+
+void composite(uint8_t *dst, const BlendLayer *layers, size_t count, size_t n) {
+    assert(count <= K_MAX_BLEND_LAYERS);
+    BlendLayer active[K_MAX_BLEND_LAYERS];
+    uint32_t f[K_MAX_BLEND_LAYERS];
+    size_t m = 0;
+    for (size_t k = 0; k < count && m < K_MAX_BLEND_LAYERS; ++k) {
+        if (layers[k].opacity == 0) continue;
+        active[m] = layers[k];
+        f[m++] = (uint32_t)layers[k].opacity + (layers[k].opacity >> 7);
+    }
+
+    // Each dst word is built in a register from all layers and stored once
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        uint32_t d = 0;
+        for (size_t k = 0; k < m; ++k)
+            d = composite_word(d, load32(active[k].src + i), active[k], f[k]);
+        store32(dst + i, d);
+    }
+    for (; i < n; ++i) {
+        uint32_t d = 0;
+        for (size_t k = 0; k < m; ++k)
+            d = composite_word(d, active[k].src[i], active[k], f[k]) & 0xFF;
+        dst[i] = static_cast<uint8_t>(d);
+    }
+}
+
+} // namespace frame_ops
+
+void Frame::resize(uint32_t width, uint32_t height, uint32_t depth) {
+    assert(width <= K_MAX_WIDTH && height <= K_MAX_HEIGHT && depth <= K_MAX_PANELS);
+    width_ = width;
+    height_ = height;
+    depth_ = depth;
+    if (voxels() > capacity_) {
+        data_.reset(new rgb_t[voxels()]);
+        capacity_ = voxels();
+    }
+    clear();
+}
+
+void Frame::clear() {
+    if (data_) memset(data(), 0, bytes());
+}
+
+void Frame::fill(rgb_t c) { frame_ops::fill(data(), voxels(), c); }
+
+void Frame::fill_layer(uint32_t z, rgb_t c) {
+    assert(z < depth_);
+    frame_ops::fill(layer(z), (size_t)width_ * height_, c);
+}
+
+void Frame::fade(uint8_t fp) { frame_ops::fade(reinterpret_cast<uint8_t *>(data()), bytes(), fp); }
+
+void Frame::fade_layer(uint32_t z, uint8_t fp) {
+    assert(z < depth_);
+    frame_ops::fade(reinterpret_cast<uint8_t *>(layer(z)), (size_t)width_ * height_ * sizeof(rgb_t), fp);
+}
+
+void Frame::blend(const Frame &other, uint8_t alpha) {
+    assert(other.voxels() == voxels());
+    frame_ops::blend(reinterpret_cast<uint8_t *>(data()), reinterpret_cast<const uint8_t *>(other.data()), bytes(),
+                     alpha);
+}
+
+void Frame::add_saturate(const Frame &other) {
+    assert(other.voxels() == voxels());
+    frame_ops::add_saturate(reinterpret_cast<uint8_t *>(data()), reinterpret_cast<const uint8_t *>(other.data()),
+                            bytes());
+}
+
+void Frame::composite(const BlendLayer *layers, size_t count) {
+    frame_ops::composite(reinterpret_cast<uint8_t *>(data()), layers, count, bytes());
+}
+
+void Frame::copy_from(const Frame &other) {
+    assert(other.voxels() == voxels());
+    memcpy(data(), other.data(), bytes());
+}
+
+} // namespace cube
@@ -0,0 +1,57 @@
+#include "frame_stats.hpp"
+
+#if CUBE_PROFILING
+
+#include <algorithm>
+#include <stdio.h>
+
+namespace cube {
+
+void FrameStats::record(const FrameTiming &t) {
+    ring_[head_] = t;
+    head_ = (head_ + 1) % K_FRAME_STATS_DEPTH;
+    if (count_ < K_FRAME_STATS_DEPTH) ++count_;
+}
+
+TimingSummary FrameStats::summarize(uint32_t FrameTiming::*field) const {
+    TimingSummary s;
+    if (count_ == 0) return s;
+
+    uint32_t v[K_FRAME_STATS_DEPTH];
+    uint64_t sum = 0;
+    for (size_t i = 0; i < count_; ++i) {
+        v[i] = ring_[i].*field;
+        sum += v[i];
+    }
+    std::sort(v, v + count_);
+    s.min = v[0];
+    s.max = v[count_ - 1];
+    s.avg = static_cast<uint32_t>(sum / count_);
+    s.p99 = v[(count_ * 99) / 100];
+    return s;
+}
+
+void FrameStats::dump(const char *name) const {
+    struct Field {
+        const char *label;
+        uint32_t FrameTiming::*member;
+    };
+    static const Field fields[] = {
+        {"render", &FrameTiming::render_us},
+        {"wait", &FrameTiming::wait_us},
+        {"encode", &FrameTiming::encode_us},
+        {"idle", &FrameTiming::idle_us},
+    };
+
+    printf("\n=== Frame timing: %s (%u frames, us) ===\n", name, (unsigned)count_);
+    printf("  %-9s %8s %8s %8s %8s\n", "", "min", "avg", "max", "p99");
+    for (const Field &f : fields) {
+        const TimingSummary s = summarize(f.member);
+        printf("  %-9s %8lu %8lu %8lu %8lu\n", f.label, (unsigned long)s.min, (unsigned long)s.avg,
+               (unsigned long)s.max, (unsigned long)s.p99);
+    }
+}
+
+} // namespace cube
+
+#endif
@@ -0,0 +1,134 @@
+#pragma once
+#include "esp_err.h"
+#include "sim_strip.hpp"
+#include "utils.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#if __has_include("soc/soc_caps.h")
+#include "soc/soc_caps.h"
+#endif
+
+namespace cube {
+
+using utils::rgb_t;
+
+// Constants for the LED chain drivers
+#define RMT_HZ (10 * 1000 * 1000)
+// Parallel outputs the chip offers: every RMT TX channel, and every general-purpose SPI bus
+// (SPI1 is the flash bus). Builds without the SoC headers assume the largest part (ESP32).
+#if defined(SOC_RMT_TX_CANDIDATES_PER_GROUP)
+#define K_MAX_RMT_CHAINS SOC_RMT_TX_CANDIDATES_PER_GROUP
+#define K_MAX_SPI_CHAINS (SOC_SPI_PERIPH_NUM - 1)
+#else
+#define K_MAX_RMT_CHAINS 8
+#define K_MAX_SPI_CHAINS 2
+#endif
+#define K_MAX_CHAINS 8 // array bound, >= every per-backend limit
+#define K_MAX_MIXED_CHAINS                                                                                             \
+    (K_MAX_RMT_CHAINS + K_MAX_SPI_CHAINS > K_MAX_CHAINS ? K_MAX_CHAINS : K_MAX_RMT_CHAINS + K_MAX_SPI_CHAINS)
+#define K_MAX_SIM_CHAINS K_MAX_CHAINS
+// WS2812 timing: 24 bits at 800 kbit/s per LED, then the latch (reset) low time
+#define K_WS2812_US_PER_LED 30
+#define K_WS2812_RESET_US 280
+#define SPI_LED_HOST SPI2_HOST // first SPI bus used by the SPI backend; chain i drives SPI_LED_HOST + i
+
+// Backend selection for the LED strip driver.
+// Mixed puts the first K_MAX_RMT_CHAINS chains on RMT channels and the rest on SPI buses, so
+// a cube can use every output of the chip at once.
+// Sim drives no hardware: each chain is a SimStrip in RAM that records the frames it is sent.
+enum class Backend : uint8_t { RMT = 0, SPI = 1, Sim = 2, Mixed = 3 };
+
+struct PanelChainConfig {
+    int pin;                  // GPIO number
+    uint16_t panels;          // number of panels in the chain
+    bool first_row_backwards; // row 0 direction
+};
+
+struct StripOps; // backend function table, internal to the cube component
+
+// The output half of a cube: one strip device per chain plus the colour output stage.
+// Callers encode voxels with set_pixel() (which applies the colour tables), then start
+// the changed chains with refresh(); transmission runs in the background until
+// wait_idle(). Owned by Cube, whose voxel-to-LED mapping decides what goes where.
+class ChainOutput {
+  public:
+    ChainOutput();
+    ~ChainOutput();
+    ChainOutput(const ChainOutput &) = delete;
+    ChainOutput &operator=(const ChainOutput &) = delete;
+    ChainOutput(ChainOutput &&other) noexcept;
+    ChainOutput &operator=(ChainOutput &&other) noexcept;
+
+    // Create the strip devices; `leds_per_panel` is panel width * height.
+    esp_err_t init(Backend backend, const PanelChainConfig *chains, size_t count, uint32_t leds_per_panel);
+
+    Backend backend() const { return backend_; }
+    size_t chain_count() const { return count_; }
+    uint32_t chain_leds(size_t ci) const { return chain_leds_[ci]; }
+    // Time one full frame spends on the wire. Chains transmit in parallel, so this is set by
+    // the longest chain and bounds the refresh rate at 1e6 / wire_time_us() fps.
+    uint32_t wire_time_us() const {
+        uint32_t longest = 0;
+        for (size_t i = 0; i < count_; ++i)
+            if (chain_leds_[i] > longest) longest = chain_leds_[i];
+        return longest * K_WS2812_US_PER_LED + K_WS2812_RESET_US;
+    }
+
+    // ----------------- Colour output stage -----------------
+    // All three settings are folded into per-channel 256-entry tables that set_pixel() applies;
+    // changing any of them rebuilds the tables once, never per pixel.
+
+    // Set global brightness factor in [0.0, 1.0]; applied to all pixels at output time.
+    void set_global_brightness(float factor);
+    // Gamma exponent applied before brightness; 1.0 (default) keeps values linear, ~2.2 looks perceptually even.
+    void set_gamma(float gamma);
+    // Per-channel white balance, 255 = unscaled. Use it to tame a dominant channel in the LEDs.
+    void set_white_balance(rgb_t wb);
+
+    // ----------------- Encode / transmit -----------------
+    esp_err_t set_pixel(uint8_t chain, uint16_t led, rgb_t v) {
+        return set_pixel_(handles_[chain], led, lut_[0][v.r], lut_[1][v.g], lut_[2][v.b]);
+    }
+    // `n` voxels into consecutive LEDs of `chain` from `led`, stepping `step` (+1 or -1) per voxel
+    esp_err_t set_row(uint8_t chain, uint32_t led, int32_t step, const rgb_t *src, uint32_t n) {
+        void *h = handles_[chain];
+        for (uint32_t i = 0; i < n; ++i, led += step) {
+            esp_err_t err = set_pixel_(h, led, lut_[0][src[i].r], lut_[1][src[i].g], lut_[2][src[i].b]);
+            if (err != ESP_OK) return err;
+        }
+        return ESP_OK;
+    }
+    // Start transmitting every chain whose bit is set in `chain_mask`, all in parallel.
+    esp_err_t refresh(uint32_t chain_mask);
+    // Block until the transmissions started by refresh() are done.
+    esp_err_t wait_idle();
+
+    // Bytes handed to the strips since init() (3 per LED per transmitted chain)
+    uint64_t bytes_sent() const { return bytes_sent_; }
+    // Recording of chain `ci` when running on Backend::Sim; nullptr for hardware backends.
+    SimStrip *sim_strip(size_t ci) const {
+        return (backend_ == Backend::Sim && ci < count_) ? static_cast<SimStrip *>(handles_[ci]) : nullptr;
+    }
+
+  private:
+    void rebuild_lut();
+    void release();
+
+    Backend backend_ = Backend::RMT;
+    size_t count_ = 0;
+    const StripOps *ops_ = nullptr;
+    // Copy of ops_->set_pixel so the inline set_pixel() needs no StripOps definition
+    esp_err_t (*set_pixel_)(void *h, uint32_t index, uint8_t r, uint8_t g, uint8_t b) = nullptr;
+    void *handles_[K_MAX_CHAINS] = {};
+    uint32_t chain_leds_[K_MAX_CHAINS] = {};
+    bool in_flight_ = false; // refresh() started transmissions not yet waited on
+    uint64_t bytes_sent_ = 0;
+
+    // Inputs of the colour output stage and the resulting tables (index 0 = r, 1 = g, 2 = b)
+    float global_brightness_ = 1.0f;
+    float gamma_ = 1.0f;
+    rgb_t white_balance_{255, 255, 255};
+    uint8_t lut_[3][256];
+};
+
+} // namespace cube
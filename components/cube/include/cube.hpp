@@ -1,33 +1,25 @@
 #pragma once
+#include "chain_output.hpp"
 #include "esp_err.h"
+#include "frame.hpp"
+#include "frame_stats.hpp"
 #include "utils.hpp"
+#include <memory>
 #include <stddef.h>
 #include <stdint.h>
+#include <utility>
 
 namespace cube {
 
 using namespace utils;
 
-// Constants for a standard 8x8x8 cube
-#define RMT_HZ (10 * 1000 * 1000)
-#define K_MAX_RMT_CHAINS 4
-#define K_MAX_SPI_CHAINS 1
-#define K_MAX_PANELS 8
-#define K_MAX_WIDTH 8
-#define K_MAX_HEIGHT 8
-
-// Backend selection for the LED strip driver
-enum class Backend : uint8_t { RMT = 0, SPI = 1 };
-
-struct PanelChainConfig {
-    int pin;                  // GPIO number
-    uint16_t panels;          // number of 8x8 panels in the chain
-    bool first_row_backwards; // row 0 direction
-};
+// Backend, PanelChainConfig and the chain limits are in chain_output.hpp;
+// voxel geometry limits are in frame.hpp.
 
 // Create-arguments used to construct the Cube
-// For SPI backend, chain_count must be exactly 1.
-// For RMT backend, chain_count must be in [1, 4].
+// For SPI backend, chain i is driven as MOSI of SPI_LED_HOST + i; up to K_MAX_SPI_CHAINS chains.
+// For RMT backend, up to K_MAX_RMT_CHAINS chains; Mixed takes up to K_MAX_MIXED_CHAINS.
+// For Sim backend, up to K_MAX_SIM_CHAINS chains.
 struct CubeCreateArgs {
     Backend backend;                // backend implementation
     const PanelChainConfig *chains; // pointer to array of chain configs
@@ -41,13 +33,35 @@ inline bool validate(const CubeCreateArgs &args) {
     if (args.chains == nullptr || args.chain_count == 0) return false;
     if (args.backend == Backend::SPI && (args.chain_count == 0 || args.chain_count > K_MAX_SPI_CHAINS)) return false;
     if (args.backend == Backend::RMT && (args.chain_count == 0 || args.chain_count > K_MAX_RMT_CHAINS)) return false;
+    if (args.backend == Backend::Sim && (args.chain_count == 0 || args.chain_count > K_MAX_SIM_CHAINS)) return false;
+    if (args.backend == Backend::Mixed && (args.chain_count == 0 || args.chain_count > K_MAX_MIXED_CHAINS))
+        return false;
+    if (args.panels_width <= 0 || args.panels_height <= 0) return false;
+    if (args.panels_width > K_MAX_WIDTH || args.panels_height > K_MAX_HEIGHT) return false;
+    size_t faces = 0;
     for (size_t i = 0; i < args.chain_count; ++i) {
         if (args.chains[i].panels == 0) return false;
+        // LED offsets within a chain are 16-bit
+        if ((size_t)args.chains[i].panels * args.panels_width * args.panels_height > 0xFFFF) return false;
+        faces += args.chains[i].panels;
     }
-    if (args.panels_width <= 0 || args.panels_height <= 0) return false;
+    if (faces > K_MAX_PANELS) return false;
     return true;
 }
 
+// Split `faces` panels over the `pin_count` outputs in `pins` as evenly as possible, so every
+// chain is about the same length and the whole cube refreshes in the time of the longest
+// one. Writes one config per used pin to `out` and returns how many were written.
+inline size_t spread_faces(uint32_t faces, const int *pins, size_t pin_count, bool first_row_backwards,
+                           PanelChainConfig *out) {
+    if (pin_count > faces) pin_count = faces;
+    for (size_t i = 0; i < pin_count; ++i) {
+        const uint32_t panels = faces / pin_count + (i < faces % pin_count ? 1 : 0);
+        out[i] = PanelChainConfig{pins[i], static_cast<uint16_t>(panels), first_row_backwards};
+    }
+    return pin_count;
+}
+
 class Cube {
   public:
     // ----------------- Basic ops -----------------
@@ -56,24 +70,22 @@ class Cube {
     // No copying
     Cube(const Cube &) = delete;
     Cube &operator=(const Cube &) = delete;
-    // Allow moving
-    Cube(Cube &&) noexcept;
-    Cube &operator=(Cube &&) noexcept;
+    // Allow moving; the strips go with the moved-to cube
+    Cube(Cube &&) noexcept = default;
+    Cube &operator=(Cube &&) noexcept = default;
 
-    // ---- Proxy that intercepts assignments to a pixel ----
-    // ---- Pixel proxy so `cube(x,y,z) = rgb` writes RAM + HW (x,y,z order) ----
+    // ---- Pixel proxy so `cube(x,y,z) = rgb` writes the back buffer (x,y,z order) ----
+    // Nothing reaches the strip until show() encodes the whole frame in one pass.
     struct PixelProxy {
         Cube *c;
         uint32_t x, y, z;
 
         // read current pixel value
-        operator rgb_t() const { return c->buf_[z][y][x]; }
+        operator rgb_t() const { return c->buf_.at(x, y, z); }
 
         PixelProxy &operator=(rgb_t v) {
-            c->buf_[z][y][x] = v;
-            // ignore or handle error:
-            esp_err_t err = c->poke(x, y, z, v);
-            if (err != ESP_OK) assert(0);
+            c->buf_.at(x, y, z) = v;
+            c->dirty_ = true;
             return *this;
         }
 
@@ -82,17 +94,33 @@ class Cube {
     };
 
     // ----------------- Accessors -----------------
+    uint32_t width() const { return panels_width_; }
+    uint32_t height() const { return panels_height_; }
+    uint32_t depth() const { return total_faces_; }
     uint32_t total_faces() const { return total_faces_; }
     uint32_t total_leds() const { return total_faces_ * panels_width_ * panels_height_; }
-    Backend backend() const { return backend_; }
+    Backend backend() const { return out_.backend(); }
     const PanelChainConfig *chains() const { return chains_; }
     size_t chain_count() const { return chain_count_; }
-
-    // Set global brightness factor in [0.0, 1.0]; applied to all pixels at output time.
+    // Bytes handed to the strips by show() since construction (3 per LED per transmitted frame)
+    uint64_t bytes_sent() const { return out_.bytes_sent(); }
+    // Wire time of one full frame, set by the longest chain (see ChainOutput::wire_time_us)
+    uint32_t wire_time_us() const { return out_.wire_time_us(); }
+    // Recording of chain `ci` when running on Backend::Sim; nullptr for hardware backends.
+    SimStrip *sim_strip(size_t ci) const { return out_.sim_strip(ci); }
+
+    // ----------------- Colour output stage (see ChainOutput) -----------------
     void set_global_brightness(float factor) {
-        if (factor < 0.0f) factor = 0.0f;
-        if (factor > 1.0f) factor = 1.0f;
-        global_brightness_ = factor;
+        out_.set_global_brightness(factor);
+        invalidate_strips();
+    }
+    void set_gamma(float gamma) {
+        out_.set_gamma(gamma);
+        invalidate_strips();
+    }
+    void set_white_balance(rgb_t wb) {
+        out_.set_white_balance(wb);
+        invalidate_strips();
     }
 
     // ----------------- Control APIs -----------------
@@ -102,37 +130,89 @@ class Cube {
     }
     const rgb_t &operator()(uint32_t x, uint32_t y, uint32_t z) const {
         assert(z < total_faces_ && y < panels_height_ && x < panels_width_);
-        return buf_[z][y][x];
+        return buf_.at(x, y, z);
+    }
+    // Last frame handed to the strip by show(); read-only, no proxy involved.
+    const rgb_t &front(uint32_t x, uint32_t y, uint32_t z) const { return front_.at(x, y, z); }
+    const Frame &front_frame() const { return front_; }
+    // Direct access to the back buffer for code that writes many voxels at once
+    Frame &frame() {
+        dirty_ = true;
+        return buf_;
     }
+    const Frame &frame() const { return buf_; }
+    // Exchange the back buffer with an off-screen frame of the same geometry, without copying:
+    // whatever was rendered into `other` becomes the next frame show() presents.
+    void swap_frame(Frame &other) {
+        assert(other.width() == buf_.width() && other.height() == buf_.height() && other.depth() == buf_.depth());
+        std::swap(buf_, other);
+        dirty_ = true;
+    }
+
+    // ----------------- Bulk ops on the back buffer (see Frame) -----------------
+    void fill(rgb_t c) { frame().fill(c); }
+    void fill_layer(uint32_t z, rgb_t c) { frame().fill_layer(z, c); }
+    void fade(uint8_t fp) { frame().fade(fp); }
+    void fade_layer(uint32_t z, uint8_t fp) { frame().fade_layer(z, fp); }
+    void blend(const Frame &other, uint8_t alpha) { frame().blend(other, alpha); }
+    void add_saturate(const Frame &other) { frame().add_saturate(other); }
+
     esp_err_t clear();
+    // Encode the back buffer and start transmitting it on every chain concurrently, then return.
+    // If the previous frame is still on the wire, this first waits for it to finish.
+    // Only rows that differ from the front buffer are re-encoded, and chains with no changed
+    // row are not retransmitted at all.
     esp_err_t show();
+    // Block until the last frame started by show() has been fully transmitted.
+    esp_err_t wait_idle() { return out_.wait_idle(); }
+    // wait_us / encode_us of the last show() (CUBE_PROFILING builds only)
+    CUBE_PROF(const FrameTiming &last_timing() const { return last_timing_; })
     void debug_dump() const;
 
+  protected:
+    // Encodes the back buffer rows that differ from the front buffer (all of them after
+    // invalidate_strips()), copies them into the front buffer and sets the bit of every chain
+    // that has to be sent. StaticCube supplies one built for its geometry.
+    using EncodeFn = esp_err_t (*)(Cube &cube, uint32_t &changed_chains);
+    Cube(const CubeCreateArgs &args, EncodeFn encode);
+
+    ChainOutput out_;
+    // Back buffer: every write lands here. Front buffer: what the strip currently shows.
+    Frame buf_;
+    Frame front_;
+    bool full_encode_ = true; // strip memory is stale as a whole (start-up, new colour tables)
+
   private:
-    Backend backend_;
-    PanelChainConfig
-        chains_[K_MAX_RMT_CHAINS > K_MAX_SPI_CHAINS ? K_MAX_RMT_CHAINS : K_MAX_SPI_CHAINS]{}; // max of the two
+    PanelChainConfig chains_[K_MAX_CHAINS]{};
     size_t chain_count_ = 0;
     uint32_t total_faces_ = 0;
     size_t panels_width_ = 0;
     size_t panels_height_ = 0;
     uint32_t pixels_per_face_ = 0;
+    EncodeFn encode_ = nullptr;
 
-    // Global brightness factor in [0.0, 1.0], applied in poke()
-    float global_brightness_ = 1.0f;
+    bool dirty_ = false; // back buffer written since the last show()
+    CUBE_PROF(FrameTiming last_timing_;)
 
-    // Backend: up to 4 chains for RMT. Each chain has its own strip handle and
-    // max_leds
-    void *handles_[K_MAX_RMT_CHAINS] = {nullptr, nullptr, nullptr, nullptr};
-    uint32_t chain_leds_[K_MAX_RMT_CHAINS] = {0, 0, 0, 0};
-    uint32_t handle_count_ = 0;
-
-    rgb_t buf_[K_MAX_PANELS][K_MAX_HEIGHT][K_MAX_WIDTH]{};
-    bool chain_dirty_[K_MAX_RMT_CHAINS] = {false, false, false, false}; // Track which chains need refresh
-
-    bool inline map_face_to_chain(uint32_t z, size_t &chain_idx, uint32_t &faces_before) const;
-    uint32_t serpentine_index(uint32_t x, uint32_t y, bool first_row_backwards);
-    esp_err_t poke(uint32_t x, uint32_t y, uint32_t z, rgb_t v);
+    // Physical address of a voxel: which chain drives it and its LED offset in that chain
+    struct LedAddr {
+        uint16_t led;
+        uint8_t chain;
+    };
+    // Built once in the constructor, indexed like buf_ (Frame::index); total_leds() entries
+    std::unique_ptr<LedAddr[]> led_map_;
+    // Chain driving each face
+    uint8_t face_chain_[K_MAX_PANELS]{};
+    static_assert(K_MAX_CHAINS <= 32, "show() tracks changed chains in a 32-bit mask");
+
+    void invalidate_strips() {
+        dirty_ = true;
+        full_encode_ = true;
+    }
+    uint32_t serpentine_index(uint32_t x, uint32_t y, bool first_row_backwards) const;
+    void build_led_map();
+    // Any geometry, through led_map_
+    static esp_err_t encode_rows(Cube &cube, uint32_t &changed_chains);
 };
 
 } // namespace cube
@@ -0,0 +1,111 @@
+#pragma once
+#include "utils.hpp"
+#include <assert.h>
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace cube {
+
+using utils::rgb_t;
+
+// Geometry of the standard 8x8 panel
+#define K_PANEL_WIDTH 8
+#define K_PANEL_HEIGHT 8
+
+// Voxel geometry limits. Buffers are allocated for the actual geometry, so these only bound
+// what a cube may ask for. K_MAX_PANELS sizes Cube's fixed per-face chain table; a chain's
+// LEDs are addressed with 16-bit offsets, which validate() checks per chain on top of these.
+#define K_MAX_PANELS 64
+#define K_MAX_WIDTH 64
+#define K_MAX_HEIGHT 64
+
+// How a layer combines with what lies below it, per channel (dst below, src the layer):
+//   Alpha: src   Add: min(dst + src, 255)   Max: max(dst, src)   Multiply: dst * src / 255
+// The layer's opacity then mixes that result with dst.
+enum class BlendMode : uint8_t { Alpha, Add, Max, Multiply };
+
+// Layers one composite() call blends; more are ignored
+#define K_MAX_BLEND_LAYERS 8
+
+// One source in a composite(): `src` points at packed RGB channel bytes
+struct BlendLayer {
+    const uint8_t *src;
+    BlendMode mode;
+    uint8_t opacity; // 0 skips the layer, 255 applies it fully
+};
+
+// Byte-level kernels behind the Frame operations, for code that works on spans of a frame (raster fills).
+// `p`, `a`, `b`, `dst` point at packed RGB channel bytes; `n` counts bytes.
+namespace frame_ops {
+void fill(rgb_t *dst, size_t voxels, rgb_t c);
+void fade(uint8_t *p, size_t n, uint8_t fp);
+void blend(uint8_t *a, const uint8_t *b, size_t n, uint8_t alpha);
+void add_saturate(uint8_t *a, const uint8_t *b, size_t n);
+// dst = layers[count - 1] over ... over layers[0] over black, in a single pass over dst
+void composite(uint8_t *dst, const BlendLayer *layers, size_t count, size_t n);
+} // namespace frame_ops
+
+// A W x H x D block of RGB voxels stored densely in (z, y, x) order, i.e. one face after
+// another, row by row. The whole-buffer operations below treat the storage as a flat byte
+// array and work on four channel bytes per 32-bit word (SWAR), so they cost one tight loop
+// instead of a read-modify-write per voxel.
+class Frame {
+  public:
+    Frame() = default;
+    Frame(uint32_t width, uint32_t height, uint32_t depth) { resize(width, height, depth); }
+    // Frames own their storage; copy contents explicitly with copy_from()
+    Frame(const Frame &) = delete;
+    Frame &operator=(const Frame &) = delete;
+    Frame(Frame &&) noexcept = default;
+    Frame &operator=(Frame &&) noexcept = default;
+
+    // Set the geometry and clear every voxel. Storage is reallocated only when it grows.
+    void resize(uint32_t width, uint32_t height, uint32_t depth);
+
+    uint32_t width() const { return width_; }
+    uint32_t height() const { return height_; }
+    uint32_t depth() const { return depth_; }
+    size_t voxels() const { return (size_t)width_ * height_ * depth_; }
+    size_t bytes() const { return voxels() * sizeof(rgb_t); }
+
+    size_t index(uint32_t x, uint32_t y, uint32_t z) const { return ((size_t)z * height_ + y) * width_ + x; }
+    rgb_t &at(uint32_t x, uint32_t y, uint32_t z) {
+        assert(x < width_ && y < height_ && z < depth_);
+        return data_[index(x, y, z)];
+    }
+    const rgb_t &at(uint32_t x, uint32_t y, uint32_t z) const {
+        assert(x < width_ && y < height_ && z < depth_);
+        return data_[index(x, y, z)];
+    }
+    rgb_t *data() { return data_.get(); }
+    const rgb_t *data() const { return data_.get(); }
+    // First voxel of face z; the face is width() * height() voxels long
+    rgb_t *layer(uint32_t z) { return data() + (size_t)z * width_ * height_; }
+    const rgb_t *layer(uint32_t z) const { return data() + (size_t)z * width_ * height_; }
+
+    // ----------------- Whole-buffer operations -----------------
+    // Frames passed as `other` must have the same dimensions.
+    void clear();
+    void fill(rgb_t c);
+    void fill_layer(uint32_t z, rgb_t c);
+    // Every channel *= fp / 255 (fp = 255 keeps the frame, 0 blacks it out)
+    void fade(uint8_t fp);
+    void fade_layer(uint32_t z, uint8_t fp);
+    // this = this + (other - this) * alpha / 255
+    void blend(const Frame &other, uint8_t alpha);
+    // this = min(this + other, 255) per channel
+    void add_saturate(const Frame &other);
+    void copy_from(const Frame &other);
+    // this = the layers blended bottom (layers[0]) to top over black; see BlendMode
+    void composite(const BlendLayer *layers, size_t count);
+
+  private:
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    uint32_t depth_ = 0;
+    size_t capacity_ = 0; // voxels allocated in data_
+    std::unique_ptr<rgb_t[]> data_;
+};
+
+} // namespace cube
@@ -0,0 +1,71 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Frame timing instrumentation. Off by default; configure with -DCUBE_PROFILING=1
+// (idf.py or the host CMake) to enable. When off, FrameStats is empty, CUBE_PROF()
+// statements vanish and nothing is measured.
+#ifndef CUBE_PROFILING
+#define CUBE_PROFILING 0
+#endif
+
+#if CUBE_PROFILING
+#include "esp_timer.h"
+#define CUBE_PROF(...) __VA_ARGS__
+#define CUBE_PROF_NOW() esp_timer_get_time()
+#else
+#define CUBE_PROF(...)
+#define CUBE_PROF_NOW() ((int64_t)0)
+#endif
+
+namespace cube {
+
+// Frames kept per FrameStats ring buffer
+#define K_FRAME_STATS_DEPTH 128
+
+// Where one frame's time went, in microseconds
+struct FrameTiming {
+    uint32_t render_us = 0; // animation step()
+    // show(): blocked until the previous frame left the wire. Transmission runs in the
+    // background, so this is only the part of it that render and idle time did not cover.
+    uint32_t wait_us = 0;
+    uint32_t encode_us = 0; // show(): back buffer -> strip memory
+    uint32_t idle_us = 0;   // sleeping until the next frame deadline
+};
+
+struct TimingSummary {
+    uint32_t min = 0, avg = 0, max = 0, p99 = 0;
+};
+
+#if CUBE_PROFILING
+
+class FrameStats {
+  public:
+    void record(const FrameTiming &t);
+    void reset() { count_ = head_ = 0; }
+    size_t count() const { return count_; }
+    // Summary of one field over the frames in the ring, e.g. summarize(&FrameTiming::encode_us)
+    TimingSummary summarize(uint32_t FrameTiming::*field) const;
+    // Print min/avg/max/p99 of every field, in the style of Cube::debug_dump()
+    void dump(const char *name) const;
+
+  private:
+    FrameTiming ring_[K_FRAME_STATS_DEPTH];
+    size_t head_ = 0;
+    size_t count_ = 0;
+};
+
+#else
+
+class FrameStats {
+  public:
+    void record(const FrameTiming &) {}
+    void reset() {}
+    size_t count() const { return 0; }
+    TimingSummary summarize(uint32_t FrameTiming::*) const { return {}; }
+    void dump(const char *) const {}
+};
+
+#endif
+
+} // namespace cube
@@ -0,0 +1,30 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace cube {
+
+// Frames kept by a SimStrip before it stops recording (counters keep running)
+#define K_SIM_RECORD_LIMIT 256
+
+// In-memory stand-in for one WS2812 chain, used by Backend::Sim.
+// Pixels are stored as RGB triplets in chain order, after the Cube's colour output stage.
+struct SimStrip {
+    uint32_t leds = 0;
+    std::vector<uint8_t> pixels; // current strip memory, leds * 3 bytes
+
+    // Every refresh appends a copy of `pixels` to `frames` until record_limit frames are held
+    bool record = true;
+    size_t record_limit = K_SIM_RECORD_LIMIT;
+    std::vector<uint8_t> frames;
+
+    uint32_t refreshes = 0;  // frames "transmitted"
+    uint64_t bytes_sent = 0; // bytes that would have gone over the wire
+
+    size_t recorded_frames() const { return leds ? frames.size() / (leds * 3) : 0; }
+    const uint8_t *frame(size_t i) const { return frames.data() + i * leds * 3; }
+    void clear_recording() { frames.clear(); }
+};
+
+} // namespace cube
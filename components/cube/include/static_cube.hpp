@@ -0,0 +1,93 @@
+#pragma once
+#include "cube.hpp"
+#include <array>
+#include <string.h>
+
+namespace cube {
+
+// A Cube whose geometry and chain layout are template parameters. It is a Cube in every
+// other respect: animations render into its frame(), the render task and the bench drive it
+// through Cube&, and the output stage is the same ChainOutput. What the template adds is a
+// show() encoder compiled for the geometry. The row width is a constant, so the row compare
+// and copy are inlined fixed-size moves. The serpentine mapping is a per-row table (start
+// LED, direction, chain) computed by the compiler into flash instead of a per-voxel map, and
+// the layout limits are checked at compile time.
+//
+// Panels are W x H; the cube is as deep as the total panel count of its chains, e.g.
+//   using DeskCube = StaticCube<4, 4, PanelChainConfig{5, 4, false}>;  // 4x4x4, one chain
+//   using HallCube = StaticCube<16, 16, PanelChainConfig{5, 8, false}, PanelChainConfig{14, 8, false}>;
+template <uint32_t W, uint32_t H, PanelChainConfig... Chains> class StaticCube : public Cube {
+  public:
+    static constexpr uint32_t kWidth = W;
+    static constexpr uint32_t kHeight = H;
+    static constexpr uint32_t kDepth = (0u + ... + Chains.panels);
+    static constexpr size_t kChainCount = sizeof...(Chains);
+    static constexpr std::array<PanelChainConfig, kChainCount> kChains{Chains...};
+
+    static_assert(W > 0 && H > 0, "panels must have at least one LED");
+    static_assert(W <= K_MAX_WIDTH && H <= K_MAX_HEIGHT && kDepth <= K_MAX_PANELS, "cube too large");
+    static_assert(((Chains.panels > 0) && ...), "every chain needs at least one panel");
+    static_assert(kChainCount >= 1 && kChainCount <= K_MAX_CHAINS, "unsupported chain count");
+    static_assert(((W * H * Chains.panels <= 65536) && ...), "LED offsets within a chain are 16-bit");
+
+    explicit StaticCube(Backend backend)
+        : Cube(CubeCreateArgs{.backend = backend,
+                              .chains = kChains.data(),
+                              .chain_count = kChainCount,
+                              .panels_width = W,
+                              .panels_height = H},
+               &StaticCube::encode_rows) {}
+
+  private:
+    // LEDs of one voxel row are contiguous in the chain, running forwards or backwards
+    struct RowAddr {
+        uint16_t start; // LED offset of x = 0
+        int8_t step;    // +1 or -1 per x
+        uint8_t chain;
+    };
+
+    // Same layout rules as Cube::build_led_map(): serpentine rows starting in the direction
+    // given by first_row_backwards, and every odd face of a chain walked in reverse.
+    static constexpr std::array<RowAddr, (size_t)kDepth * H> build_rows() {
+        std::array<RowAddr, (size_t)kDepth * H> rows{};
+        uint32_t z = 0;
+        for (size_t ci = 0; ci < kChainCount; ++ci) {
+            for (uint32_t local_face = 0; local_face < kChains[ci].panels; ++local_face, ++z) {
+                const uint32_t base = local_face * W * H;
+                const bool first_row_backwards = kChains[ci].first_row_backwards;
+                for (uint32_t y = 0; y < H; ++y) {
+                    const bool row_back = (y % 2 == 0) ? first_row_backwards : !first_row_backwards;
+                    uint32_t idx0 = y * W + (row_back ? W - 1 : 0);
+                    int32_t step = row_back ? -1 : 1;
+                    if (local_face % 2 != 0) {
+                        idx0 = (W * H - 1) - idx0;
+                        step = -step;
+                    }
+                    rows[(size_t)z * H + y] = RowAddr{static_cast<uint16_t>(base + idx0), static_cast<int8_t>(step),
+                                                      static_cast<uint8_t>(ci)};
+                }
+            }
+        }
+        return rows;
+    }
+    static constexpr std::array<RowAddr, (size_t)kDepth * H> kRows = build_rows();
+
+    // Cube::EncodeFn for this geometry; rows in Frame order are faces row by row, like kRows
+    static esp_err_t encode_rows(Cube &base, uint32_t &changed_chains) {
+        auto &c = static_cast<StaticCube &>(base);
+        const rgb_t *back = c.buf_.data();
+        rgb_t *sent = c.front_.data();
+        const bool full = c.full_encode_;
+        for (size_t r = 0; r < (size_t)kDepth * H; ++r, back += W, sent += W) {
+            if (!full && memcmp(back, sent, W * sizeof(rgb_t)) == 0) continue;
+            const RowAddr row = kRows[r];
+            changed_chains |= 1u << row.chain;
+            esp_err_t err = c.out_.set_row(row.chain, row.start, row.step, back, W);
+            if (err != ESP_OK) return err;
+            memcpy(sent, back, W * sizeof(rgb_t));
+        }
+        return ESP_OK;
+    }
+};
+
+} // namespace cube
@@ -0,0 +1,24 @@
+#pragma once
+// Internal to the cube component: the per-chain output device behind Cube.
+#include "cube.hpp"
+
+namespace cube {
+
+// Operations show()/wait_idle() need from a chain. All chains of a Cube share one table;
+// `h` is the chain's opaque handle.
+struct StripOps {
+    esp_err_t (*set_pixel)(void *h, uint32_t index, uint8_t r, uint8_t g, uint8_t b);
+    esp_err_t (*refresh_async)(void *h);
+    esp_err_t (*wait_done)(void *h);
+    void (*del)(void *h);
+};
+
+// led_strip device on an RMT channel or an SPI bus (strip_led.cpp); only built with ESP-IDF.
+// `backend` is RMT or SPI; SPI chains use bus SPI_LED_HOST + `spi_bus`.
+esp_err_t led_strip_chain_new(Backend backend, int pin, uint32_t leds, uint32_t spi_bus, void **out,
+                              const StripOps **ops);
+
+// In-memory strip that records refreshed frames (strip_sim.cpp); built everywhere.
+esp_err_t sim_chain_new(uint32_t leds, void **out, const StripOps **ops);
+
+} // namespace cube
@@ -0,0 +1,54 @@
+// Chain backend on top of the led_strip component (RMT or SPI)
+#include "led_strip.h"
+#include "soc/soc_caps.h"
+#include "strip.hpp"
+
+namespace cube {
+
+static esp_err_t led_set_pixel(void *h, uint32_t index, uint8_t r, uint8_t g, uint8_t b) {
+    return led_strip_set_pixel((led_strip_handle_t)h, index, r, g, b);
+}
+
+static esp_err_t led_refresh_async(void *h) { return led_strip_refresh_async((led_strip_handle_t)h); }
+
+static esp_err_t led_wait_done(void *h) { return led_strip_refresh_wait_done((led_strip_handle_t)h); }
+
+static void led_del(void *h) { led_strip_del((led_strip_handle_t)h); }
+
+static const StripOps k_led_strip_ops = {led_set_pixel, led_refresh_async, led_wait_done, led_del};
+
+esp_err_t led_strip_chain_new(Backend backend, int pin, uint32_t leds, uint32_t spi_bus, void **out,
+                              const StripOps **ops) {
+    led_strip_config_t sc = {};
+    sc.strip_gpio_num = pin;
+    sc.max_leds = leds;
+    sc.led_model = LED_MODEL_WS2812;
+    sc.color_component_format = LED_STRIP_COLOR_COMPONENT_FMT_GRB;
+    sc.flags.invert_out = false;
+
+    led_strip_handle_t handle = nullptr;
+    esp_err_t err = ESP_ERR_NOT_SUPPORTED;
+    if (backend == Backend::RMT) {
+        led_strip_rmt_config_t rc = {};
+        rc.clk_src = RMT_CLK_SRC_DEFAULT;
+        rc.resolution_hz = RMT_HZ;
+        rc.mem_block_symbols = SOC_RMT_MEM_WORDS_PER_CHANNEL; // default
+        rc.flags.with_dma = 0;                                // C6: no RMT-DMA
+        err = led_strip_new_rmt_device(&sc, &rc, &handle);
+    } else if (backend == Backend::SPI) {
+        // The chain pin becomes MOSI; the whole frame is streamed from a DMA buffer
+        if (spi_bus >= K_MAX_SPI_CHAINS) return ESP_ERR_INVALID_ARG;
+        led_strip_spi_config_t spc = {};
+        spc.clk_src = SPI_CLK_SRC_DEFAULT;
+        spc.spi_bus = static_cast<spi_host_device_t>(SPI_LED_HOST + spi_bus);
+        spc.flags.with_dma = 1;
+        err = led_strip_new_spi_device(&sc, &spc, &handle);
+    }
+    if (err != ESP_OK) return err;
+
+    *out = handle;
+    *ops = &k_led_strip_ops;
+    return ESP_OK;
+}
+
+} // namespace cube
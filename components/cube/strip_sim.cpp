@@ -0,0 +1,42 @@
+// Chain backend that only records into memory, for host builds and off-hardware profiling
+#include "sim_strip.hpp"
+#include "strip.hpp"
+
+namespace cube {
+
+static esp_err_t sim_set_pixel(void *h, uint32_t index, uint8_t r, uint8_t g, uint8_t b) {
+    auto *s = static_cast<SimStrip *>(h);
+    if (index >= s->leds) return ESP_ERR_INVALID_ARG;
+    uint8_t *p = &s->pixels[index * 3];
+    p[0] = r;
+    p[1] = g;
+    p[2] = b;
+    return ESP_OK;
+}
+
+static esp_err_t sim_refresh_async(void *h) {
+    auto *s = static_cast<SimStrip *>(h);
+    ++s->refreshes;
+    s->bytes_sent += s->pixels.size();
+    if (s->record && s->recorded_frames() < s->record_limit) {
+        s->frames.insert(s->frames.end(), s->pixels.begin(), s->pixels.end());
+    }
+    return ESP_OK;
+}
+
+static esp_err_t sim_wait_done(void *) { return ESP_OK; }
+
+static void sim_del(void *h) { delete static_cast<SimStrip *>(h); }
+
+static const StripOps k_sim_strip_ops = {sim_set_pixel, sim_refresh_async, sim_wait_done, sim_del};
+
+esp_err_t sim_chain_new(uint32_t leds, void **out, const StripOps **ops) {
+    auto *s = new SimStrip();
+    s->leds = leds;
+    s->pixels.assign(leds * 3, 0);
+    *out = s;
+    *ops = &k_sim_strip_ops;
+    return ESP_OK;
+}
+
+} // namespace cube
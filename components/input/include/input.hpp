@@ -0,0 +1,64 @@
+#pragma once
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "soc/gpio_num.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Buttons. The GPIO interrupt only timestamps the edge into a lock-free ring and wakes the
+// input task; debouncing and gesture detection (click, double click, long press) run in that
+// task, and the resulting events go to a handler and a queue.
+namespace input {
+
+#define K_INPUT_MAX_BUTTONS 8
+// Raw edges in flight between the ISR and the task; a power of two
+#define K_INPUT_RING_SIZE 64
+// A button's level must be stable this long after its last edge to count
+#define K_INPUT_DEBOUNCE_US (20 * 1000)
+#define K_INPUT_LONG_PRESS_US (600 * 1000)
+// A second press within this long after a release makes a double click
+#define K_INPUT_DOUBLE_CLICK_US (300 * 1000)
+#define K_INPUT_QUEUE_LEN 16
+#define K_INPUT_TASK_STACK 3072
+// Above the render task, so input is handled while a frame renders
+#define K_INPUT_TASK_PRIO 6
+
+enum class EventType : uint8_t {
+    Press,       // debounced press, as soon as it is stable
+    Release,     // debounced release
+    Click,       // press and release, once no second press followed within the double-click time
+                 // (at the release for buttons without double-click detection)
+    DoubleClick, // second release of two quick presses (no Click is sent for either)
+    LongPress,   // held for K_INPUT_LONG_PRESS_US (no Click follows the release)
+};
+
+struct Event {
+    uint8_t button; // index into the configuration passed to init()
+    EventType type;
+    int64_t time_us; // esp_timer time of the edge (Press/Release) or of the detection
+};
+
+struct ButtonConfig {
+    gpio_num_t pin;
+    bool active_low; // pressed pulls the pin low (internal pull-up), else high (pull-down)
+    // Detect double clicks. Off, every release that ends no long press is a Click straight
+    // away, instead of K_INPUT_DOUBLE_CLICK_US later, and DoubleClick is never sent.
+    bool double_click = true;
+};
+
+// Called on the input task for every event; keep it short (e.g. hand the event on)
+typedef void (*Handler)(const Event &event, void *ctx);
+
+// Configure the pins, install their interrupts and start the input task.
+esp_err_t init(const ButtonConfig *buttons, size_t count, Handler handler = nullptr, void *ctx = nullptr);
+
+// Every event is also posted here, for tasks that prefer to block on input
+QueueHandle_t queue();
+
+// Edges lost because the ring was full, and events lost because the queue was full
+uint32_t dropped_edges();
+uint32_t dropped_events();
+
+} // namespace input
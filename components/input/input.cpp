@@ -0,0 +1,234 @@
+#include "input.hpp"
+#include "driver/gpio.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/task.h"
+#include <atomic>
+
+namespace input {
+
+static const char *TAG = "input";
+
+// Single producer (the GPIO interrupt service dispatches every pin's handler from one
+// interrupt) and single consumer (the input task)
+struct Edge {
+    int64_t time_us;
+    uint8_t button;
+};
+
+static Edge s_ring[K_INPUT_RING_SIZE];
+static std::atomic<uint32_t> s_head{0}; // written by the ISR
+static std::atomic<uint32_t> s_tail{0}; // written by the task
+static std::atomic<uint32_t> s_dropped_edges{0};
+static std::atomic<uint32_t> s_dropped_events{0};
+static_assert((K_INPUT_RING_SIZE & (K_INPUT_RING_SIZE - 1)) == 0, "ring indices wrap with a mask");
+
+// Per-button state, owned by the input task
+struct Button {
+    ButtonConfig cfg;
+    bool pressed = false;
+    bool settling = false;   // edges seen, level not yet stable
+    bool long_fired = false; // this press already reported LongPress
+    bool second = false;     // this press is the second of a double click
+    int64_t first_edge_us = 0;
+    int64_t settle_at = 0;
+    int64_t long_at = 0;  // 0 = not armed
+    int64_t click_at = 0; // pending Click, sent unless a second press comes first
+};
+
+static Button s_buttons[K_INPUT_MAX_BUTTONS];
+static size_t s_count = 0;
+static Handler s_handler = nullptr;
+static void *s_ctx = nullptr;
+static QueueHandle_t s_queue = nullptr;
+static TaskHandle_t s_task = nullptr;
+
+static void IRAM_ATTR gpio_isr(void *arg) {
+    const uint32_t head = s_head.load(std::memory_order_relaxed);
+    if (head - s_tail.load(std::memory_order_acquire) >= K_INPUT_RING_SIZE) {
+        s_dropped_edges.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        Edge &e = s_ring[head & (K_INPUT_RING_SIZE - 1)];
+        e.time_us = esp_timer_get_time();
+        e.button = static_cast<uint8_t>(reinterpret_cast<uintptr_t>(arg));
+        s_head.store(head + 1, std::memory_order_release);
+    }
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(s_task, &woken);
+    if (woken == pdTRUE) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+static void emit(uint8_t button, EventType type, int64_t time_us) {
+    const Event e{button, type, time_us};
+    if (s_handler) s_handler(e, s_ctx);
+    if (xQueueSend(s_queue, &e, 0) != pdTRUE) s_dropped_events.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void on_change(uint8_t i, Button &b, int64_t t) {
+    if (b.pressed) {
+        emit(i, EventType::Press, t);
+        b.long_at = t + K_INPUT_LONG_PRESS_US;
+        b.long_fired = false;
+        b.second = b.click_at != 0;
+        b.click_at = 0;
+        return;
+    }
+    emit(i, EventType::Release, t);
+    b.long_at = 0;
+    if (b.long_fired) return;
+    if (!b.cfg.double_click) {
+        emit(i, EventType::Click, t);
+        return;
+    }
+    if (b.second) {
+        emit(i, EventType::DoubleClick, t);
+        b.second = false;
+        return;
+    }
+    b.click_at = t + K_INPUT_DOUBLE_CLICK_US;
+}
+
+// Settle bouncing pins and fire due long-press and click timers; returns the next deadline
+static int64_t poll_buttons(int64_t now) {
+    int64_t next = INT64_MAX;
+    auto due = [&](int64_t at) {
+        if (at == 0) return false;
+        if (at <= now) return true;
+        if (at < next) next = at;
+        return false;
+    };
+
+    for (size_t i = 0; i < s_count; ++i) {
+        Button &b = s_buttons[i];
+        if (b.settling && due(b.settle_at)) {
+            b.settling = false;
+            const bool pressed = gpio_get_level(b.cfg.pin) == (b.cfg.active_low ? 0 : 1);
+            if (pressed != b.pressed) {
+                b.pressed = pressed;
+                on_change(static_cast<uint8_t>(i), b, b.first_edge_us);
+            }
+        }
+        if (b.pressed && due(b.long_at)) {
+            emit(static_cast<uint8_t>(i), EventType::LongPress, now);
+            b.long_fired = true;
+            b.long_at = 0;
+        }
+        if (due(b.click_at)) {
+            emit(static_cast<uint8_t>(i), EventType::Click, now);
+            b.click_at = 0;
+        }
+    }
+    return next;
+}
+
+static void input_task(void *) {
+    TickType_t wait = portMAX_DELAY;
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, wait);
+
+        // Drain the ring: every edge restarts its button's settle time
+        const uint32_t head = s_head.load(std::memory_order_acquire);
+        uint32_t tail = s_tail.load(std::memory_order_relaxed);
+        for (; tail != head; ++tail) {
+            const Edge &e = s_ring[tail & (K_INPUT_RING_SIZE - 1)];
+            Button &b = s_buttons[e.button];
+            if (!b.settling) b.first_edge_us = e.time_us;
+            b.settling = true;
+            b.settle_at = e.time_us + K_INPUT_DEBOUNCE_US;
+        }
+        s_tail.store(tail, std::memory_order_release);
+
+        const int64_t now = esp_timer_get_time();
+        const int64_t next = poll_buttons(now);
+        if (next == INT64_MAX) {
+            wait = portMAX_DELAY;
+        } else {
+            // Round up so the deadline has passed when the wait ends
+            const int64_t ms = (next - now + 999) / 1000;
+            wait = pdMS_TO_TICKS(ms);
+            if (wait == 0) wait = 1;
+        }
+    }
+}
+
+// Undo a failed init(): remove the first `handlers` interrupt handlers, stop the task and
+// free the queue, so init() can be tried again. The shared ISR service stays installed.
+static void teardown(size_t handlers) {
+    for (size_t i = 0; i < handlers; ++i)
+        gpio_isr_handler_remove(s_buttons[i].cfg.pin);
+    if (s_task) {
+        vTaskDelete(s_task);
+        s_task = nullptr;
+    }
+    if (s_queue) {
+        vQueueDelete(s_queue);
+        s_queue = nullptr;
+    }
+    s_count = 0;
+    s_handler = nullptr;
+    s_ctx = nullptr;
+}
+
+esp_err_t init(const ButtonConfig *buttons, size_t count, Handler handler, void *ctx) {
+    if (s_task) return ESP_ERR_INVALID_STATE;
+    if (count == 0 || count > K_INPUT_MAX_BUTTONS) return ESP_ERR_INVALID_ARG;
+
+    s_queue = xQueueCreate(K_INPUT_QUEUE_LEN, sizeof(Event));
+    if (!s_queue) return ESP_ERR_NO_MEM;
+    s_handler = handler;
+    s_ctx = ctx;
+
+    for (size_t i = 0; i < count; ++i) {
+        Button &b = s_buttons[i];
+        b = Button{};
+        b.cfg = buttons[i];
+
+        gpio_config_t io_conf = {};
+        io_conf.pin_bit_mask = 1ULL << b.cfg.pin;
+        io_conf.mode = GPIO_MODE_INPUT;
+        io_conf.intr_type = GPIO_INTR_ANYEDGE;
+        io_conf.pull_up_en = b.cfg.active_low ? GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE;
+        io_conf.pull_down_en = b.cfg.active_low ? GPIO_PULLDOWN_DISABLE : GPIO_PULLDOWN_ENABLE;
+        esp_err_t err = gpio_config(&io_conf);
+        if (err != ESP_OK) {
+            teardown(0);
+            return err;
+        }
+        b.pressed = gpio_get_level(b.cfg.pin) == (b.cfg.active_low ? 0 : 1);
+    }
+    s_count = count;
+
+    // The task must exist before the first interrupt notifies it
+    if (xTaskCreate(input_task, "input", K_INPUT_TASK_STACK, nullptr, K_INPUT_TASK_PRIO, &s_task) != pdPASS) {
+        s_task = nullptr;
+        teardown(0);
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) { // already installed is fine
+        teardown(0);
+        return err;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        const gpio_num_t pin = s_buttons[i].cfg.pin;
+        err = gpio_isr_handler_add(pin, gpio_isr, reinterpret_cast<void *>(static_cast<uintptr_t>(i)));
+        if (err != ESP_OK) {
+            teardown(i);
+            return err;
+        }
+        ESP_LOGI(TAG, "button %u on GPIO%d (%s)", (unsigned)i, pin,
+                 s_buttons[i].cfg.active_low ? "active-low" : "active-high");
+    }
+    return ESP_OK;
+}
+
+QueueHandle_t queue() { return s_queue; }
+
+uint32_t dropped_edges() { return s_dropped_edges.load(std::memory_order_relaxed); }
+
+uint32_t dropped_events() { return s_dropped_events.load(std::memory_order_relaxed); }
+
+} // namespace input
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "fixed.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Fixed-point 3D gradient noise (Perlin's improved noise) and a volume of it that drifts through
+// the noise field over time, for the plasma, fire and clouds animations.
+//
+// Noise values are Q15 (-32767..32767 for -1..1). Inside, lattice fractions and fade weights
+// are Q12, so every product fits in 32 bits without a 64-bit multiply.
+namespace noise {
+
+using fx::q16;
+using fx::vec3;
+
+#define K_NOISE_FRAC_BITS 12
+#define K_NOISE_ONE (1 << K_NOISE_FRAC_BITS)
+// The lattice repeats every this many cells along each axis
+#define K_NOISE_PERIOD 256
+#define K_NOISE_MAX_OCTAVES 4
+// Default time between two fully evaluated volumes; the frames in between are interpolated
+#define K_NOISE_KEY_MS 240
+
+// One coordinate split into its lattice cell, the fraction of the way through the cell and
+// that fraction through the fade curve, all Q12. Shared by every point with that coordinate.
+struct Axis {
+    uint8_t cell;
+    uint16_t frac;
+    uint16_t fade;
+};
+
+class Noise3 {
+  public:
+    explicit Noise3(uint64_t seed = 0) { reseed(seed); }
+    // A new permutation of the lattice gradients
+    void reseed(uint64_t seed);
+
+    static Axis axis(q16 v);
+    // n coordinates start, start + step, ...
+    static void axis_run(q16 start, q16 step, uint32_t n, Axis *out);
+
+    // Noise at one point, in Q16 lattice units
+    int16_t sample(q16 x, q16 y, q16 z) const;
+    // Noise at (xs[i], y, z) for i < n. The gradients of a cell's eight corners and their
+    // y and z parts of the dot products are kept while the row stays in that cell, so each
+    // point costs eight multiply-adds for the x terms and the seven lerps.
+    void row(const Axis *xs, uint32_t n, const Axis &y, const Axis &z, int16_t *out) const;
+
+  private:
+    uint8_t perm_[2 * K_NOISE_PERIOD];
+};
+
+struct NoiseParams {
+    q16 scale = fx::to_q16(0.25f); // lattice cells per voxel, first octave
+    // Each octave has twice the frequency and half the amplitude of the one before
+    uint8_t octaves = 2;
+    // Lattice cells per second the first octave moves through the volume; octave n moves
+    // n + 1 times as fast in its own cells, so the octaves slide over one another and the
+    // field changes shape instead of just scrolling
+    vec3 drift = {fx::to_q16(0.3f), 0, fx::to_q16(0.2f)};
+    uint32_t key_ms = K_NOISE_KEY_MS;
+};
+
+// A volume of fractal noise at voxel resolution, moving with time. The noise is only evaluated
+// in full at keyframes `key_ms` apart. Frames in between interpolate the two keyframes around
+// them, while the keyframe after those is built a few rows per frame. So a frame costs the
+// interpolation plus about voxels * octaves * frame time / key_ms noise samples. A step longer
+// than a key interval finishes the build at once; one longer than two rebuilds both keyframes.
+class NoiseVolume {
+  public:
+    // Size the buffers for the target's geometry (allocates) and build the first keyframes
+    void init(uint32_t width, uint32_t height, uint32_t depth, const NoiseParams &params, uint64_t seed);
+    // Move time on by `dt_ms` and build what is due of the next keyframe
+    void advance(uint32_t dt_ms);
+
+    // Noise at voxel `i` in Frame order, Q15, interpolated to the current time
+    int16_t value(size_t i) const { return (int16_t)(from_[i] + (((to_[i] - from_[i]) * mix_) >> 8)); }
+    size_t voxels() const { return from_ ? (size_t)width_ * height_ * depth_ : 0; }
+    // Noise samples evaluated by the last advance(), for cost checks
+    uint32_t samples_last() const { return samples_last_; }
+
+  private:
+    // Axis values of keyframe `key` for every octave, into axes_
+    void prepare_axes(uint32_t key);
+    void build_rows(int16_t *out, uint32_t begin, uint32_t end);
+    void build_key(int16_t *out, uint32_t key);
+    // Begin building next_ as keyframe key_ + 2
+    void start_key();
+
+    Noise3 noise_;
+    NoiseParams params_;
+    uint32_t width_ = 0, height_ = 0, depth_ = 0;
+    std::vector<int16_t> storage_;
+    int16_t *from_ = nullptr, *to_ = nullptr, *next_ = nullptr;
+    uint32_t key_ = 0;      // keyframe index of from_
+    uint32_t phase_ms_ = 0; // time since keyframe key_
+    int32_t mix_ = 0;       // weight of to_, 0..256
+    uint32_t rows_built_ = 0; // of next_ (keyframe key_ + 2); a row is one (y, z)
+    // Per octave, the axis values of the keyframe under construction
+    std::vector<Axis> axes_;
+    std::vector<int32_t> acc_; // one row, octaves summed
+    std::vector<int16_t> row_; // one row of one octave
+    int32_t norm_ = 0; // Q16 gain bringing the octave sum back to -1..1
+    uint32_t samples_last_ = 0;
+};
+
+} // namespace noise
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "common.hpp"
+#include "noise.hpp"
+
+// Animations that colour a moving NoiseVolume voxel by voxel. Their per-frame cost is the
+// volume's interpolation and palette lookup for every voxel plus a share of the next keyframe
+// (see NoiseVolume), whatever the frame rate.
+namespace noise_animation {
+
+using namespace anim_common;
+using noise::NoiseParams;
+using noise::NoiseVolume;
+
+#define K_NOISE_ANIM_FRAME_MS 30
+
+// Shared init/step: a volume over the target's geometry that advances by dt_ms every step
+class NoiseAnim : public IAnimation {
+  public:
+    void init(Frame &target) override;
+    void step(Frame &target, uint32_t dt_ms) override;
+    uint32_t frame_period_ms() const override { return K_NOISE_ANIM_FRAME_MS; }
+
+    const NoiseVolume &volume() const { return volume_; }
+
+  protected:
+    virtual NoiseParams params() const = 0;
+    // Colour the whole target from volume_
+    virtual void paint(Frame &target) = 0;
+
+    NoiseVolume volume_;
+    uint32_t elapsed_ms_ = 0;
+};
+
+// Two octaves sliding past each other, mapped round the colour wheel, which also turns slowly
+class PlasmaAnim : public NoiseAnim {
+  public:
+    const char *name() const override { return "plasma"; }
+
+  protected:
+    NoiseParams params() const override;
+    void paint(Frame &target) override;
+};
+
+// Three octaves rising through the cube, hotter at the bottom, through a black-red-yellow-
+// white palette
+class FireAnim : public NoiseAnim {
+  public:
+    const char *name() const override { return "fire"; }
+
+  protected:
+    NoiseParams params() const override;
+    void paint(Frame &target) override;
+};
+
+// Slow three-octave fog drifting sideways: white where the noise is above the cloud cover,
+// a dim blue sky elsewhere, with the undersides of the clouds a little darker
+class CloudsAnim : public NoiseAnim {
+  public:
+    const char *name() const override { return "clouds"; }
+    uint32_t frame_period_ms() const override { return 2 * K_NOISE_ANIM_FRAME_MS; }
+
+  protected:
+    NoiseParams params() const override;
+    void paint(Frame &target) override;
+};
+
+} // namespace noise_animation
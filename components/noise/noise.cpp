@@ -0,0 +1,194 @@
+#include "noise.hpp"
+#include "rng.hpp"
+
+namespace noise {
+
+// Perlin's twelve edge gradients, padded to sixteen so a hash picks one with a mask
+static const int8_t kGrad[16][3] = {
+    {1, 1, 0}, {-1, 1, 0}, {1, -1, 0}, {-1, -1, 0}, {1, 0, 1},  {-1, 0, 1}, {1, 0, -1}, {-1, 0, -1},
+    {0, 1, 1}, {0, -1, 1}, {0, 1, -1}, {0, -1, -1}, {1, 1, 0},  {0, -1, 1}, {-1, 1, 0}, {0, -1, -1},
+};
+
+// 6t^5 - 15t^4 + 10t^3 in Q12: zero slope and curvature at both ends of a cell
+static inline uint16_t fade(int32_t t) {
+    const int32_t inner = ((t * (6 * t - 15 * K_NOISE_ONE)) >> K_NOISE_FRAC_BITS) + 10 * K_NOISE_ONE;
+    const int32_t t3 = (((t * t) >> K_NOISE_FRAC_BITS) * t) >> K_NOISE_FRAC_BITS;
+    return (uint16_t)((t3 * inner) >> K_NOISE_FRAC_BITS);
+}
+
+static inline int32_t lerp(int32_t t, int32_t a, int32_t b) { return a + (((b - a) * t) >> K_NOISE_FRAC_BITS); }
+
+static inline int16_t clamp_q15(int32_t v) { return (int16_t)(v > 32767 ? 32767 : v < -32767 ? -32767 : v); }
+
+void Noise3::reseed(uint64_t seed) {
+    utils::Rng rng(seed);
+    for (int i = 0; i < K_NOISE_PERIOD; ++i)
+        perm_[i] = (uint8_t)i;
+    for (int i = K_NOISE_PERIOD - 1; i > 0; --i) {
+        const uint32_t j = rng.below((uint32_t)i + 1);
+        const uint8_t t = perm_[i];
+        perm_[i] = perm_[j];
+        perm_[j] = t;
+    }
+    // Doubled, so cell + 1 and the chained lookups never need wrapping
+    for (int i = 0; i < K_NOISE_PERIOD; ++i)
+        perm_[K_NOISE_PERIOD + i] = perm_[i];
+}
+
+Axis Noise3::axis(q16 v) {
+    const uint16_t frac = (uint16_t)((v & (K_Q16_ONE - 1)) >> (K_Q16_SHIFT - K_NOISE_FRAC_BITS));
+    return Axis{(uint8_t)(v >> K_Q16_SHIFT), frac, fade(frac)};
+}
+
+void Noise3::axis_run(q16 start, q16 step, uint32_t n, Axis *out) {
+    for (uint32_t i = 0; i < n; ++i, start += step)
+        out[i] = axis(start);
+}
+
+int16_t Noise3::sample(q16 x, q16 y, q16 z) const {
+    const Axis ax = axis(x);
+    int16_t out;
+    row(&ax, 1, axis(y), axis(z), &out);
+    return out;
+}
+
+void Noise3::row(const Axis *xs, uint32_t n, const Axis &y, const Axis &z, int16_t *out) const {
+    const uint8_t *p = perm_;
+    const int32_t yf[2] = {y.frac, y.frac - K_NOISE_ONE};
+    const int32_t zf[2] = {z.frac, z.frac - K_NOISE_ONE};
+    // Corner c is at (c & 1, c >> 1 & 1, c >> 2) from the cell's origin. Its dot product is
+    // gx[c] * x frac + part[c], part holding the y and z terms and the x corner offset.
+    int32_t gx[8] = {}, part[8] = {};
+    int cell = -1;
+    for (uint32_t i = 0; i < n; ++i) {
+        const Axis &x = xs[i];
+        if (x.cell != cell) {
+            cell = x.cell;
+            const int a = p[cell] + y.cell, b = p[cell + 1] + y.cell;
+            const int aa = p[a] + z.cell, ab = p[a + 1] + z.cell, ba = p[b] + z.cell, bb = p[b + 1] + z.cell;
+            const uint8_t hash[8] = {p[aa], p[ba], p[ab], p[bb], p[aa + 1], p[ba + 1], p[ab + 1], p[bb + 1]};
+            for (int c = 0; c < 8; ++c) {
+                const int8_t *g = kGrad[hash[c] & 15];
+                gx[c] = g[0];
+                part[c] = g[1] * yf[(c >> 1) & 1] + g[2] * zf[c >> 2] - ((c & 1) ? g[0] * K_NOISE_ONE : 0);
+            }
+        }
+        const int32_t xf = x.frac;
+        const int32_t x00 = lerp(x.fade, gx[0] * xf + part[0], gx[1] * xf + part[1]);
+        const int32_t x10 = lerp(x.fade, gx[2] * xf + part[2], gx[3] * xf + part[3]);
+        const int32_t x01 = lerp(x.fade, gx[4] * xf + part[4], gx[5] * xf + part[5]);
+        const int32_t x11 = lerp(x.fade, gx[6] * xf + part[6], gx[7] * xf + part[7]);
+        const int32_t v = lerp(z.fade, lerp(y.fade, x00, x10), lerp(y.fade, x01, x11));
+        out[i] = clamp_q15(v << (15 - K_NOISE_FRAC_BITS));
+    }
+}
+
+void NoiseVolume::init(uint32_t width, uint32_t height, uint32_t depth, const NoiseParams &params, uint64_t seed) {
+    noise_.reseed(seed);
+    params_ = params;
+    if (params_.octaves < 1) params_.octaves = 1;
+    if (params_.octaves > K_NOISE_MAX_OCTAVES) params_.octaves = K_NOISE_MAX_OCTAVES;
+    if (params_.key_ms == 0) params_.key_ms = 1;
+    width_ = width;
+    height_ = height;
+    depth_ = depth;
+
+    const size_t n = (size_t)width * height * depth;
+    storage_.assign(3 * n, 0);
+    from_ = storage_.data();
+    to_ = from_ + n;
+    next_ = to_ + n;
+    axes_.resize((size_t)params_.octaves * (width + height + depth));
+    acc_.resize(width);
+    row_.resize(width);
+    // Octave amplitudes 1, 1/2, 1/4, ... sum to 2 - 2^(1 - octaves)
+    norm_ = (int32_t)(((int64_t)K_Q16_ONE << (params_.octaves - 1)) / ((1 << params_.octaves) - 1));
+
+    key_ = 0;
+    phase_ms_ = 0;
+    mix_ = 0;
+    build_key(from_, 0);
+    build_key(to_, 1);
+    start_key();
+    samples_last_ = 0;
+}
+
+void NoiseVolume::prepare_axes(uint32_t key) {
+    const int64_t t_ms = (int64_t)key * params_.key_ms;
+    // Keeps the start inside one lattice period; the lattice repeats anyway
+    const int64_t wrap = ((int64_t)K_NOISE_PERIOD << K_Q16_SHIFT) - 1;
+    Axis *a = axes_.data();
+    for (uint32_t o = 0; o < params_.octaves; ++o) {
+        const q16 step = params_.scale << o;
+        // Octaves start apart, so their lattices do not line up at the origin
+        const int64_t offset = (int64_t)o * fx::to_q16(37.53f);
+        const int64_t ms = t_ms * (o + 1);
+        Noise3::axis_run((q16)((offset + params_.drift.x * ms / 1000) & wrap), step, width_, a);
+        a += width_;
+        Noise3::axis_run((q16)((offset + params_.drift.y * ms / 1000) & wrap), step, height_, a);
+        a += height_;
+        Noise3::axis_run((q16)((offset + params_.drift.z * ms / 1000) & wrap), step, depth_, a);
+        a += depth_;
+    }
+}
+
+void NoiseVolume::build_rows(int16_t *out, uint32_t begin, uint32_t end) {
+    const uint32_t per_octave = width_ + height_ + depth_;
+    for (uint32_t r = begin; r < end; ++r) {
+        // Row r is voxels (0.., y, z) with r = z * height + y, as in Frame order
+        const uint32_t y = r % height_, z = r / height_;
+        for (uint32_t o = 0; o < params_.octaves; ++o) {
+            const Axis *xs = axes_.data() + o * per_octave;
+            noise_.row(xs, width_, xs[width_ + y], xs[width_ + height_ + z], row_.data());
+            for (uint32_t i = 0; i < width_; ++i)
+                acc_[i] = (o ? acc_[i] : 0) + (row_[i] >> o);
+        }
+        int16_t *dst = out + (size_t)r * width_;
+        for (uint32_t i = 0; i < width_; ++i)
+            dst[i] = clamp_q15((acc_[i] * norm_) >> K_Q16_SHIFT);
+    }
+    samples_last_ += (end - begin) * width_ * params_.octaves;
+}
+
+void NoiseVolume::build_key(int16_t *out, uint32_t key) {
+    prepare_axes(key);
+    build_rows(out, 0, height_ * depth_);
+}
+
+void NoiseVolume::start_key() {
+    prepare_axes(key_ + 2);
+    rows_built_ = 0;
+}
+
+void NoiseVolume::advance(uint32_t dt_ms) {
+    samples_last_ = 0;
+    if (!from_) return;
+    const uint32_t key_ms = params_.key_ms;
+    const uint32_t rows = height_ * depth_;
+    phase_ms_ += dt_ms;
+    if (phase_ms_ >= 2 * key_ms) {
+        key_ += phase_ms_ / key_ms;
+        phase_ms_ %= key_ms;
+        build_key(from_, key_);
+        build_key(to_, key_ + 1);
+        start_key();
+    } else if (phase_ms_ >= key_ms) {
+        build_rows(next_, rows_built_, rows);
+        int16_t *const old = from_;
+        from_ = to_;
+        to_ = next_;
+        next_ = old;
+        ++key_;
+        phase_ms_ -= key_ms;
+        start_key();
+    }
+    // Keep the build in step with the interval, so it is done when the interval ends
+    const uint32_t due = (uint32_t)((uint64_t)rows * phase_ms_ / key_ms);
+    if (due > rows_built_) {
+        build_rows(next_, rows_built_, due);
+        rows_built_ = due;
+    }
+    mix_ = (int32_t)(phase_ms_ * 256 / key_ms);
+}
+
+} // namespace noise
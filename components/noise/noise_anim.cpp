@@ -0,0 +1,116 @@
+#include "noise_anim.hpp"
+#include "rng.hpp"
+#include "utils.hpp"
+
+namespace noise_animation {
+
+using namespace utils;
+
+void NoiseAnim::init(Frame &target) {
+    elapsed_ms_ = 0;
+    volume_.init(target.width(), target.height(), target.depth(), params(), rng_seed());
+    target.clear();
+}
+
+void NoiseAnim::step(Frame &target, uint32_t dt_ms) {
+    if (volume_.voxels() != target.voxels()) return;
+    elapsed_ms_ += dt_ms;
+    volume_.advance(dt_ms);
+    paint(target);
+}
+
+// ------------------------------ plasma ------------------------------
+
+NoiseParams PlasmaAnim::params() const {
+    NoiseParams p;
+    p.scale = fx::to_q16(0.2f);
+    p.octaves = 2;
+    p.drift = {fx::to_q16(0.4f), fx::to_q16(0.25f), fx::to_q16(0.3f)};
+    p.key_ms = 240;
+    return p;
+}
+
+void PlasmaAnim::paint(Frame &target) {
+    // The wheel turns once every ~10 s under the pattern
+    const uint8_t turn = static_cast<uint8_t>(elapsed_ms_ / 40);
+    rgb_t *out = target.data();
+    const size_t n = volume_.voxels();
+    for (size_t i = 0; i < n; ++i)
+        out[i] = color_wheel(static_cast<uint8_t>((volume_.value(i) >> 7) + turn));
+}
+
+// ------------------------------- fire -------------------------------
+
+NoiseParams FireAnim::params() const {
+    NoiseParams p;
+    p.scale = fx::to_q16(0.3f);
+    p.octaves = 3;
+    // Negative y: the pattern rises through the cube
+    p.drift = {0, fx::to_q16(-1.5f), fx::to_q16(0.2f)};
+    p.key_ms = 150;
+    return p;
+}
+
+// Black to red to yellow to white
+static rgb_t heat_color(uint8_t heat) {
+    const int32_t t = heat * 3;
+    auto ramp = [](int32_t v) { return static_cast<uint8_t>(v < 0 ? 0 : v > 255 ? 255 : v); };
+    return rgb_t{ramp(t), ramp(t - 255), ramp(t - 510)};
+}
+
+void FireAnim::paint(Frame &target) {
+    const uint32_t W = target.width(), H = target.height(), D = target.depth();
+    // Heat lost per row going up: the top row only burns where the noise peaks
+    const int32_t falloff = 416 / static_cast<int32_t>(H > 1 ? H - 1 : 1);
+    rgb_t *out = target.data();
+    size_t i = 0;
+    for (uint32_t z = 0; z < D; ++z) {
+        for (uint32_t y = 0; y < H; ++y) {
+            const int32_t base = 208 - static_cast<int32_t>(y) * falloff;
+            for (uint32_t x = 0; x < W; ++x, ++i) {
+                const int32_t heat = base + ((volume_.value(i) * 3) >> 9);
+                out[i] = heat_color(static_cast<uint8_t>(heat < 0 ? 0 : heat > 255 ? 255 : heat));
+            }
+        }
+    }
+}
+
+// ------------------------------ clouds ------------------------------
+
+// Noise level (Q15 >> 7) a voxel has to exceed to be cloud
+#define CLOUD_COVER 16
+
+NoiseParams CloudsAnim::params() const {
+    NoiseParams p;
+    p.scale = fx::to_q16(0.18f);
+    p.octaves = 3;
+    p.drift = {fx::to_q16(0.2f), 0, fx::to_q16(0.08f)};
+    p.key_ms = 480;
+    return p;
+}
+
+void CloudsAnim::paint(Frame &target) {
+    const uint32_t W = target.width(), H = target.height(), D = target.depth();
+    const rgb_t sky{0, 4, 24};
+    rgb_t *out = target.data();
+    size_t i = 0;
+    for (uint32_t z = 0; z < D; ++z) {
+        for (uint32_t y = 0; y < H; ++y) {
+            // Tops lit, undersides in shadow
+            const int32_t white = 150 + static_cast<int32_t>(105 * y / (H > 1 ? H - 1 : 1));
+            for (uint32_t x = 0; x < W; ++x, ++i) {
+                const int32_t density = (volume_.value(i) >> 7) - CLOUD_COVER;
+                if (density <= 0) {
+                    out[i] = sky;
+                    continue;
+                }
+                const int32_t a = density * 4 > 256 ? 256 : density * 4;
+                out[i] = rgb_t{static_cast<uint8_t>(sky.r + (((white - sky.r) * a) >> 8)),
+                               static_cast<uint8_t>(sky.g + (((white - sky.g) * a) >> 8)),
+                               static_cast<uint8_t>(sky.b + (((white - sky.b) * a) >> 8))};
+            }
+        }
+    }
+}
+
+} // namespace noise_animation
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "frame.hpp"
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace particles {
+
+using cube::Frame;
+using utils::rgb_t;
+
+// Positions and velocities are Q8.8 fixed point: 256 = one voxel (or one voxel per second)
+#define K_PARTICLE_FRAC_BITS 8
+#define K_PARTICLE_ONE (1 << K_PARTICLE_FRAC_BITS)
+// Particles spawned with this lifetime never age; they only die by leaving the bounds
+#define K_PARTICLE_IMMORTAL 0xFFFF
+
+constexpr int32_t to_fx(float v) { return static_cast<int32_t>(v * K_PARTICLE_ONE); }
+// Centre of voxel `i` in Q8.8
+constexpr int32_t voxel_fx(int32_t i) { return i * K_PARTICLE_ONE + K_PARTICLE_ONE / 2; }
+
+// Everything a new particle needs. x/y/z in Q8.8 voxels, vx/vy/vz in Q8.8 voxels per second.
+struct Emit {
+    int32_t x, y, z;
+    int32_t vx, vy, vz;
+    uint16_t life_ms; // K_PARTICLE_IMMORTAL for no ageing
+    rgb_t color;
+};
+
+// How render() combines a particle with the voxel underneath it
+enum class Blend : uint8_t { Replace, Add };
+
+// Fixed-capacity pool of point particles.
+// Fields are stored as separate arrays (structure of arrays) so update() streams through
+// positions and velocities without touching colours. Free slots form a stack, so spawn()
+// and a particle's death are O(1); live particles are tracked in a dense index list that
+// update() and render() walk without looking at dead slots.
+class ParticleSystem {
+  public:
+    ParticleSystem() = default;
+    explicit ParticleSystem(uint16_t capacity) { reserve(capacity); }
+
+    // (Re)allocate for `capacity` particles; drops every live particle.
+    void reserve(uint16_t capacity);
+    // Kill every particle, keeping the allocation
+    void clear();
+
+    uint16_t capacity() const { return capacity_; }
+    uint16_t alive() const { return alive_count_; }
+
+    // Constant acceleration applied to every particle, Q8.8 voxels per second squared
+    void set_gravity(int32_t ax, int32_t ay, int32_t az) {
+        ax_ = ax;
+        ay_ = ay;
+        az_ = az;
+    }
+    // Particles leaving [0, w) x [0, h) x [0, d) die; all zero (default) disables the check
+    void set_bounds(uint32_t w, uint32_t h, uint32_t d) {
+        bound_w_ = w * K_PARTICLE_ONE;
+        bound_h_ = h * K_PARTICLE_ONE;
+        bound_d_ = d * K_PARTICLE_ONE;
+    }
+    // Scale each particle's colour by its remaining lifetime when rendering
+    void set_fade_with_age(bool on) { fade_with_age_ = on; }
+    void set_blend(Blend b) { blend_ = b; }
+
+    // Returns false, spawning nothing, when the pool is full.
+    bool spawn(const Emit &e);
+
+    // Integrate velocity and gravity over `dt_ms`, age every particle and retire the dead.
+    void update(uint32_t dt_ms);
+    // Draw every live particle into `frame`; particles outside it are skipped.
+    void render(Frame &frame) const;
+    void step(Frame &frame, uint32_t dt_ms) {
+        update(dt_ms);
+        render(frame);
+    }
+
+  private:
+    void kill(uint16_t alive_pos);
+
+    uint16_t capacity_ = 0;
+    std::unique_ptr<int32_t[]> x_, y_, z_;
+    std::unique_ptr<int32_t[]> vx_, vy_, vz_;
+    std::unique_ptr<uint16_t[]> life_, life0_; // remaining and initial lifetime, ms
+    std::unique_ptr<rgb_t[]> color_;
+
+    // Free slot stack and dense list of live slots
+    std::unique_ptr<uint16_t[]> free_;
+    uint16_t free_count_ = 0;
+    std::unique_ptr<uint16_t[]> alive_;
+    uint16_t alive_count_ = 0;
+
+    int32_t ax_ = 0, ay_ = 0, az_ = 0;
+    int32_t bound_w_ = 0, bound_h_ = 0, bound_d_ = 0;
+    bool fade_with_age_ = false;
+    Blend blend_ = Blend::Replace;
+};
+
+} // namespace particles
@@ -0,0 +1,118 @@
+#include "particles.hpp"
+
+namespace particles {
+
+// Longest time step update() integrates in one go; keeps the Q8.8 products within 32 bits
+#define K_PARTICLE_MAX_DT_MS 250
+
+void ParticleSystem::reserve(uint16_t capacity) {
+    capacity_ = capacity;
+    x_.reset(new int32_t[capacity]);
+    y_.reset(new int32_t[capacity]);
+    z_.reset(new int32_t[capacity]);
+    vx_.reset(new int32_t[capacity]);
+    vy_.reset(new int32_t[capacity]);
+    vz_.reset(new int32_t[capacity]);
+    life_.reset(new uint16_t[capacity]);
+    life0_.reset(new uint16_t[capacity]);
+    color_.reset(new rgb_t[capacity]);
+    free_.reset(new uint16_t[capacity]);
+    alive_.reset(new uint16_t[capacity]);
+    clear();
+}
+
+void ParticleSystem::clear() {
+    // Hand out low slots first so a lightly used pool stays compact
+    for (uint16_t i = 0; i < capacity_; ++i)
+        free_[i] = capacity_ - 1 - i;
+    free_count_ = capacity_;
+    alive_count_ = 0;
+}
+
+bool ParticleSystem::spawn(const Emit &e) {
+    if (free_count_ == 0) return false;
+    const uint16_t s = free_[--free_count_];
+    x_[s] = e.x;
+    y_[s] = e.y;
+    z_[s] = e.z;
+    vx_[s] = e.vx;
+    vy_[s] = e.vy;
+    vz_[s] = e.vz;
+    life_[s] = e.life_ms;
+    life0_[s] = e.life_ms;
+    color_[s] = e.color;
+    alive_[alive_count_++] = s;
+    return true;
+}
+
+// Swap-remove from the live list and return the slot to the free stack
+void ParticleSystem::kill(uint16_t alive_pos) {
+    const uint16_t s = alive_[alive_pos];
+    alive_[alive_pos] = alive_[--alive_count_];
+    free_[free_count_++] = s;
+}
+
+void ParticleSystem::update(uint32_t dt_ms) {
+    if (dt_ms > K_PARTICLE_MAX_DT_MS) dt_ms = K_PARTICLE_MAX_DT_MS;
+    // dt in seconds as Q16, so per-second rates scale with one multiply and shift
+    const int32_t f = static_cast<int32_t>((dt_ms << 16) / 1000);
+    const int32_t dvx = (ax_ * f) >> 16;
+    const int32_t dvy = (ay_ * f) >> 16;
+    const int32_t dvz = (az_ * f) >> 16;
+    const bool bounded = bound_w_ | bound_h_ | bound_d_;
+
+    for (uint16_t i = 0; i < alive_count_;) {
+        const uint16_t s = alive_[i];
+
+        if (life_[s] != K_PARTICLE_IMMORTAL) {
+            if (life_[s] <= dt_ms) {
+                kill(i);
+                continue;
+            }
+            life_[s] -= dt_ms;
+        }
+
+        vx_[s] += dvx;
+        vy_[s] += dvy;
+        vz_[s] += dvz;
+        x_[s] += (vx_[s] * f) >> 16;
+        y_[s] += (vy_[s] * f) >> 16;
+        z_[s] += (vz_[s] * f) >> 16;
+
+        if (bounded && (x_[s] < 0 || y_[s] < 0 || z_[s] < 0 || x_[s] >= bound_w_ || y_[s] >= bound_h_ ||
+                        z_[s] >= bound_d_)) {
+            kill(i);
+            continue;
+        }
+        ++i;
+    }
+}
+
+void ParticleSystem::render(Frame &frame) const {
+    if (alive_count_ == 0) return;
+    rgb_t *dst = frame.data();
+    const int32_t w = frame.width(), h = frame.height(), d = frame.depth();
+
+    for (uint16_t i = 0; i < alive_count_; ++i) {
+        const uint16_t s = alive_[i];
+        const int32_t x = x_[s] >> K_PARTICLE_FRAC_BITS;
+        const int32_t y = y_[s] >> K_PARTICLE_FRAC_BITS;
+        const int32_t z = z_[s] >> K_PARTICLE_FRAC_BITS;
+        if (x < 0 || y < 0 || z < 0 || x >= w || y >= h || z >= d) continue;
+
+        rgb_t c = color_[s];
+        if (fade_with_age_ && life0_[s] != K_PARTICLE_IMMORTAL) {
+            c = utils::scale(c, static_cast<uint8_t>((uint32_t)life_[s] * 255 / life0_[s]));
+        }
+        rgb_t &v = dst[frame.index(x, y, z)];
+        if (blend_ == Blend::Add) {
+            v.r = static_cast<uint8_t>(v.r + c.r > 255 ? 255 : v.r + c.r);
+            v.g = static_cast<uint8_t>(v.g + c.g > 255 ? 255 : v.g + c.g);
+            v.b = static_cast<uint8_t>(v.b + c.b > 255 ? 255 : v.b + c.b);
+        } else {
+            v = c;
+        }
+    }
+}
+
+} // namespace particles
@@ -0,0 +1,147 @@
+#include "blit.hpp"
+#include <string.h>
+
+namespace raster {
+
+// A plane resolved against a frame: linear index steps and the (u, v) window inside it
+struct Walk {
+    int64_t base;       // linear index of the plane origin (may lie outside the frame)
+    int32_t su, sv;     // linear index step per u and per v
+    int32_t u_lo, u_hi; // u range that stays inside the frame, inclusive
+    int32_t v_lo, v_hi;
+};
+
+static int axis_of(const ivec3 &d, int32_t &sign) {
+    if (d.x) {
+        sign = d.x;
+        return 0;
+    }
+    if (d.y) {
+        sign = d.y;
+        return 1;
+    }
+    sign = d.z;
+    return 2;
+}
+
+// Steps k with 0 <= o + k * s < n, for s = +1 or -1
+static void axis_range(int32_t o, int32_t s, int32_t n, int32_t &lo, int32_t &hi) {
+    if (s > 0) {
+        lo = -o;
+        hi = n - 1 - o;
+    } else {
+        lo = o - (n - 1);
+        hi = o;
+    }
+}
+
+static bool make_walk(const Frame &f, const Plane &p, Walk &w) {
+    const int32_t n[3] = {(int32_t)f.width(), (int32_t)f.height(), (int32_t)f.depth()};
+    const int32_t stride[3] = {1, n[0], n[0] * n[1]};
+    const int32_t o[3] = {p.origin.x, p.origin.y, p.origin.z};
+    int32_t sign_u, sign_v;
+    const int au = axis_of(p.du, sign_u);
+    const int av = axis_of(p.dv, sign_v);
+    if (au == av) return false;
+    const int fixed = 3 - au - av;
+    if (o[fixed] < 0 || o[fixed] >= n[fixed]) return false;
+
+    axis_range(o[au], sign_u, n[au], w.u_lo, w.u_hi);
+    axis_range(o[av], sign_v, n[av], w.v_lo, w.v_hi);
+    w.su = sign_u * stride[au];
+    w.sv = sign_v * stride[av];
+    w.base = (int64_t)o[0] + (int64_t)o[1] * stride[1] + (int64_t)o[2] * stride[2];
+    return true;
+}
+
+bool plane_window(const Frame &f, const Plane &p, int32_t &u_lo, int32_t &u_hi) {
+    Walk w;
+    if (!make_walk(f, p, w)) return false;
+    u_lo = w.u_lo;
+    u_hi = w.u_hi;
+    return true;
+}
+
+template <class Row>
+static void blit_rows(Frame &f, const Plane &p, Row row, uint32_t height, uint32_t width, int32_t u0, int32_t v0,
+                      rgb_t fg, const rgb_t *bg, uint32_t scale) {
+    Walk w;
+    if (!make_walk(f, p, w) || width == 0 || scale == 0) return;
+    if (width > 32) width = 32;
+    rgb_t *data = f.data();
+    const int32_t s = (int32_t)scale;
+
+    // Mask columns whose scaled block overlaps the frame window
+    int32_t c_lo = (w.u_lo - u0) / s, c_hi = (w.u_hi - u0) / s;
+    if (w.u_lo - u0 < 0) c_lo = 0;
+    if (c_hi > (int32_t)width - 1) c_hi = (int32_t)width - 1;
+    if (w.u_hi - u0 < 0 || c_lo > c_hi) return;
+    const uint32_t clip = (0xFFFFFFFFu >> c_lo) & (0xFFFFFFFFu << (31 - c_hi));
+
+    for (uint32_t r = 0; r < height; ++r) {
+        const uint32_t on = row(r) & clip;
+        const uint32_t off = bg ? (~row(r) & clip) : 0;
+        if (!(on | off)) continue;
+        for (int32_t sy = 0; sy < s; ++sy) {
+            const int32_t v = v0 + (int32_t)r * s + sy;
+            if (v < w.v_lo || v > w.v_hi) continue;
+            const int64_t line = w.base + (int64_t)v * w.sv; // index of u = 0, may be off-frame
+            // Set bits in fg, then clear bits in bg; only the bits themselves are visited
+            for (int pass = 0; pass < (bg ? 2 : 1); ++pass) {
+                uint32_t bits = pass ? off : on;
+                const rgb_t c = pass ? *bg : fg;
+                while (bits) {
+                    const int col = __builtin_clz(bits);
+                    bits &= ~(0x80000000u >> col);
+                    const int32_t u = u0 + col * s;
+                    if (s == 1) {
+                        data[line + (int64_t)u * w.su] = c;
+                        continue;
+                    }
+                    for (int32_t sx = 0; sx < s; ++sx)
+                        if (u + sx >= w.u_lo && u + sx <= w.u_hi) data[line + (int64_t)(u + sx) * w.su] = c;
+                }
+            }
+        }
+    }
+}
+
+void blit_mask(Frame &f, const Plane &p, const uint32_t *rows, uint32_t height, uint32_t width, int32_t u0,
+               int32_t v0, rgb_t fg, const rgb_t *bg, uint32_t scale) {
+    blit_rows(f, p, [rows](uint32_t r) { return rows[r]; }, height, width, u0, v0, fg, bg, scale);
+}
+
+void blit_mask8(Frame &f, const Plane &p, const uint8_t *rows, uint32_t height, int32_t u0, int32_t v0, rgb_t fg,
+                const rgb_t *bg, uint32_t scale) {
+    blit_rows(f, p, [rows](uint32_t r) { return (uint32_t)rows[r] << 24; }, height, 8, u0, v0, fg, bg, scale);
+}
+
+void blit_rgb(Frame &f, const Plane &p, const rgb_t *pixels, uint32_t width, uint32_t height, int32_t u0, int32_t v0,
+              const rgb_t *key) {
+    Walk w;
+    if (!make_walk(f, p, w)) return;
+    int32_t c_lo = w.u_lo - u0, c_hi = w.u_hi - u0;
+    if (c_lo < 0) c_lo = 0;
+    if (c_hi > (int32_t)width - 1) c_hi = (int32_t)width - 1;
+    if (c_lo > c_hi) return;
+    rgb_t *data = f.data();
+
+    for (uint32_t r = 0; r < height; ++r) {
+        const int32_t v = v0 + (int32_t)r;
+        if (v < w.v_lo || v > w.v_hi) continue;
+        const int64_t line = w.base + (int64_t)v * w.sv;
+        const rgb_t *src = pixels + (size_t)r * width;
+        // Opaque rows along +x are contiguous in the frame
+        if (!key && w.su == 1) {
+            memcpy(data + line + u0 + c_lo, src + c_lo, (size_t)(c_hi - c_lo + 1) * sizeof(rgb_t));
+            continue;
+        }
+        for (int32_t c = c_lo; c <= c_hi; ++c) {
+            const rgb_t px = src[c];
+            if (key && px.r == key->r && px.g == key->g && px.b == key->b) continue;
+            data[line + (int64_t)(u0 + c) * w.su] = px;
+        }
+    }
+}
+
+} // namespace raster
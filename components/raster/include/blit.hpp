@@ -0,0 +1,41 @@
+#pragma once
+
+#include "raster.hpp"
+#include <stdint.h>
+
+// Sprite blitter: copies 1-bit masks and RGB sprites onto any axis-aligned plane of a Frame.
+// 1-bit rows are handled as whole masks: each row is clipped with one AND and only its set
+// bits are visited, so transparent pixels cost nothing.
+namespace raster {
+
+// Sprite pixel (u, v) lands on voxel origin + u * du + v * dv, where du and dv are unit
+// vectors along different axes (components -1, 0 or 1). Row v = 0 is the sprite's top row.
+struct Plane {
+    ivec3 origin;
+    ivec3 du;
+    ivec3 dv;
+};
+
+// Face z as seen from the front: u runs along +x, v runs down from the top row (y = H - 1)
+inline Plane face_plane(const Frame &f, uint32_t z) {
+    return Plane{ivec3{0, (int32_t)f.height() - 1, (int32_t)z}, ivec3{1, 0, 0}, ivec3{0, -1, 0}};
+}
+
+// Range of u (inclusive) that plane `p` keeps inside the frame; false if the plane misses it
+bool plane_window(const Frame &f, const Plane &p, int32_t &u_lo, int32_t &u_hi);
+
+// Blit a 1-bit sprite of `height` rows and `width` <= 32 columns. Row bits are MSB first:
+// bit 31 is column 0. Set bits are drawn in `fg`, each as a `scale` x `scale` block; clear
+// bits are left untouched, or drawn in *bg when `bg` is given.
+void blit_mask(Frame &f, const Plane &p, const uint32_t *rows, uint32_t height, uint32_t width, int32_t u0,
+               int32_t v0, rgb_t fg, const rgb_t *bg = nullptr, uint32_t scale = 1);
+// Same for 8-column sprites stored one byte per row (bit 7 is column 0), e.g. font glyphs
+void blit_mask8(Frame &f, const Plane &p, const uint8_t *rows, uint32_t height, int32_t u0, int32_t v0, rgb_t fg,
+                const rgb_t *bg = nullptr, uint32_t scale = 1);
+
+// Blit a `width` x `height` RGB sprite stored row by row. Pixels equal to *key are
+// transparent when `key` is given.
+void blit_rgb(Frame &f, const Plane &p, const rgb_t *pixels, uint32_t width, uint32_t height, int32_t u0, int32_t v0,
+              const rgb_t *key = nullptr);
+
+} // namespace raster
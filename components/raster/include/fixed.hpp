@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <stddef.h>
+#include <stdint.h>
+
+// Fixed-point math for per-voxel work on targets without an FPU. Values are Q16.16 in an
+// int32_t; angles are 16-bit binary angles (65536 = one full turn).
+namespace fx {
+
+using q16 = int32_t;
+
+#define K_Q16_SHIFT 16
+#define K_Q16_ONE (1 << K_Q16_SHIFT)
+#define K_ANGLE_TURN 65536u // binary angle units per full turn
+
+constexpr q16 to_q16(float v) { return static_cast<q16>(v * K_Q16_ONE); }
+constexpr q16 from_int(int32_t v) { return v * K_Q16_ONE; }
+constexpr float to_float(q16 v) { return static_cast<float>(v) / K_Q16_ONE; }
+// Round to the nearest integer
+constexpr int32_t round_int(q16 v) { return (v + K_Q16_ONE / 2) >> K_Q16_SHIFT; }
+constexpr int32_t floor_int(q16 v) { return v >> K_Q16_SHIFT; }
+
+constexpr q16 mul(q16 a, q16 b) { return static_cast<q16>(((int64_t)a * b) >> K_Q16_SHIFT); }
+constexpr q16 div(q16 a, q16 b) { return static_cast<q16>(((int64_t)a << K_Q16_SHIFT) / b); }
+// Radians to binary angle
+constexpr uint16_t angle_from_rad(float rad) { return static_cast<uint16_t>((int32_t)(rad * 10430.378f)); }
+
+// ----------------- Integer square root -----------------
+// floor(sqrt(v)), bit by bit; no multiplies or divides
+constexpr uint32_t isqrt(uint64_t v) {
+    uint64_t res = 0;
+    uint64_t bit = 1ull << 62;
+    while (bit > v)
+        bit >>= 2;
+    while (bit) {
+        if (v >= res + bit) {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return static_cast<uint32_t>(res);
+}
+// sqrt of a non-negative Q16 value, in Q16
+constexpr q16 sqrt(q16 v) { return v <= 0 ? 0 : static_cast<q16>(isqrt((uint64_t)v << K_Q16_SHIFT)); }
+
+// ----------------- Sine / cosine -----------------
+#define K_SIN_TABLE_BITS 8 // quarter-wave entries = 1 << bits
+
+namespace detail {
+// sin(x) for x in [0, pi/2] by Taylor series; only used to build the table at compile time
+constexpr double sin_taylor(double x) {
+    double term = x, sum = x;
+    for (int n = 1; n < 12; ++n) {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+constexpr std::array<q16, (1 << K_SIN_TABLE_BITS) + 1> make_sin_table() {
+    std::array<q16, (1 << K_SIN_TABLE_BITS) + 1> t{};
+    for (size_t i = 0; i < t.size(); ++i) {
+        const double x = 1.5707963267948966 * (double)i / (1 << K_SIN_TABLE_BITS);
+        t[i] = static_cast<q16>(sin_taylor(x) * K_Q16_ONE + 0.5);
+    }
+    return t;
+}
+// Quarter wave plus the endpoint, so interpolation never wraps
+inline constexpr std::array<q16, (1 << K_SIN_TABLE_BITS) + 1> kSinTable = make_sin_table();
+} // namespace detail
+
+// sin of a binary angle in Q16, linearly interpolated between table entries
+constexpr q16 sin(uint16_t angle) {
+    constexpr uint32_t frac_bits = 14 - K_SIN_TABLE_BITS; // bits below the table index
+    const uint32_t quadrant = angle >> 14;
+    uint32_t a = angle & 0x3FFF;
+    if (quadrant & 1) a = 0x4000 - a; // mirror in the 2nd and 4th quadrants
+    const uint32_t i = a >> frac_bits;
+    const int32_t f = static_cast<int32_t>(a & ((1u << frac_bits) - 1));
+    q16 v = detail::kSinTable[i];
+    if (f) v += ((detail::kSinTable[i + 1] - v) * f) >> frac_bits;
+    return (quadrant & 2) ? -v : v;
+}
+constexpr q16 cos(uint16_t angle) { return sin(static_cast<uint16_t>(angle + 0x4000)); }
+
+// ----------------- Vectors -----------------
+struct vec3 {
+    q16 x, y, z;
+};
+
+constexpr vec3 operator+(const vec3 &a, const vec3 &b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+constexpr vec3 operator-(const vec3 &a, const vec3 &b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+constexpr vec3 scale(const vec3 &a, q16 s) { return {mul(a.x, s), mul(a.y, s), mul(a.z, s)}; }
+constexpr q16 dot(const vec3 &a, const vec3 &b) {
+    return static_cast<q16>(((int64_t)a.x * b.x + (int64_t)a.y * b.y + (int64_t)a.z * b.z) >> K_Q16_SHIFT);
+}
+constexpr q16 length(const vec3 &a) {
+    return static_cast<q16>(isqrt((uint64_t)((int64_t)a.x * a.x + (int64_t)a.y * a.y + (int64_t)a.z * a.z)));
+}
+// Voxel (x, y, z) as a Q16 point
+constexpr vec3 voxel(int32_t x, int32_t y, int32_t z) { return {from_int(x), from_int(y), from_int(z)}; }
+
+} // namespace fx
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "blit.hpp"
+#include <stdint.h>
+
+// 5x7 ASCII font in 8x8 cells for text on the cube, drawn with the blitter
+namespace raster {
+
+#define K_FONT_FIRST 0x20 // ' '
+#define K_FONT_LAST 0x7E  // '~'
+#define K_FONT_HEIGHT 8
+#define K_FONT_ADVANCE 6 // 5 glyph columns + 1 column of spacing
+
+// Row masks of printable ASCII character `c`, K_FONT_HEIGHT bytes, bit 7 = leftmost column.
+// Characters outside the font map to '?'.
+const uint8_t *glyph(char c);
+
+// Width of `text` in columns when drawn with draw_text()
+uint32_t text_width(const char *text);
+
+// Draw `text` on plane `p` with its top-left corner at (u0, v0); background left untouched.
+// Glyphs wholly outside the plane's window are skipped, so long scrolling strings are cheap.
+void draw_text(Frame &f, const Plane &p, const char *text, int32_t u0, int32_t v0, rgb_t color);
+
+} // namespace raster
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "fixed.hpp"
+#include "frame.hpp"
+#include <stdint.h>
+
+// Volumetric shape rasterisers. Each one writes straight into a Frame and only visits the
+// voxels near its shape (per-row spans or a tight bounding box), instead of testing every
+// voxel of the cube. Shapes are clipped to the frame; positions are in voxel units, with
+// voxel (x, y, z) centred on the integer point (x, y, z).
+namespace raster {
+
+using cube::Frame;
+using fx::q16;
+using fx::vec3;
+using utils::rgb_t;
+
+struct ivec3 {
+    int32_t x, y, z;
+};
+
+// Voxels at distance in [r_inner, r_outer] from `c`
+void sphere_shell(Frame &f, const vec3 &c, q16 r_inner, q16 r_outer, rgb_t color);
+inline void sphere(Frame &f, const vec3 &c, q16 r, rgb_t color) { sphere_shell(f, c, 0, r, color); }
+
+// Disc of `radius` centred on `c` with unit normal `n`, extending `half_thickness` on
+// either side of its plane
+void disc(Frame &f, const vec3 &c, const vec3 &n, q16 radius, q16 half_thickness, rgb_t color);
+
+// 3D Bresenham line between two voxels, both ends included
+void line(Frame &f, ivec3 a, ivec3 b, rgb_t color);
+// Line from `origin` along the unit vector `dir` for `length` voxels
+void ray(Frame &f, const vec3 &origin, const vec3 &dir, q16 length, rgb_t color);
+
+// Axis-aligned box with inclusive corners, filled or as its 12 edges
+void box(Frame &f, ivec3 lo, ivec3 hi, rgb_t color);
+void box_edges(Frame &f, ivec3 lo, ivec3 hi, rgb_t color);
+
+} // namespace raster
@@ -0,0 +1,148 @@
+#include "raster.hpp"
+
+namespace raster {
+
+using fx::isqrt;
+using fx::mul;
+
+// Integer voxel bounds of [c - e, c + e] (Q16), clipped to [0, n)
+static inline void span(q16 c, q16 e, int32_t n, int32_t &lo, int32_t &hi) {
+    lo = -((e - c) >> K_Q16_SHIFT); // ceil((c - e) / 1)
+    hi = (c + e) >> K_Q16_SHIFT;    // floor((c + e) / 1)
+    if (lo < 0) lo = 0;
+    if (hi > n - 1) hi = n - 1;
+}
+
+static inline void fill_span(Frame &f, int32_t x0, int32_t x1, int32_t y, int32_t z, rgb_t color) {
+    rgb_t *row = f.data() + f.index(0, y, z);
+    for (int32_t x = x0; x <= x1; ++x)
+        row[x] = color;
+}
+
+// Squared distances are Q32 in int64: voxel centres are whole Q16 values, so a voxel is
+// inside a radius exactly when dx^2 <= r^2 - dy^2 - dz^2, i.e. |dx| <= isqrt(remainder).
+void sphere_shell(Frame &f, const vec3 &c, q16 r_inner, q16 r_outer, rgb_t color) {
+    const int32_t w = f.width(), h = f.height(), d = f.depth();
+    const int64_t ro2 = (int64_t)r_outer * r_outer;
+    const int64_t ri2 = (int64_t)r_inner * r_inner;
+
+    int32_t z0, z1;
+    span(c.z, r_outer, d, z0, z1);
+    for (int32_t z = z0; z <= z1; ++z) {
+        const int64_t dz = (int64_t)fx::from_int(z) - c.z;
+        const int64_t rem_z = ro2 - dz * dz;
+        if (rem_z < 0) continue;
+        int32_t y0, y1;
+        span(c.y, static_cast<q16>(isqrt(rem_z)), h, y0, y1);
+        for (int32_t y = y0; y <= y1; ++y) {
+            const int64_t dy = (int64_t)fx::from_int(y) - c.y;
+            const int64_t dyz2 = dy * dy + dz * dz;
+            const int64_t rem_o = ro2 - dyz2;
+            if (rem_o < 0) continue;
+            int32_t x0, x1;
+            span(c.x, static_cast<q16>(isqrt(rem_o)), w, x0, x1);
+            if (x0 > x1) continue;
+
+            const int64_t rem_i = ri2 - dyz2;
+            if (rem_i <= 0) {
+                fill_span(f, x0, x1, y, z, color);
+                continue;
+            }
+            // Voxels with dx^2 < rem_i are inside the hole: |dx| <= isqrt(rem_i - 1)
+            const q16 hole = static_cast<q16>(isqrt(rem_i - 1));
+            const int32_t hole_lo = -((hole - c.x) >> K_Q16_SHIFT);
+            const int32_t hole_hi = (c.x + hole) >> K_Q16_SHIFT;
+            fill_span(f, x0, hole_lo - 1 < x1 ? hole_lo - 1 : x1, y, z, color);
+            fill_span(f, hole_hi + 1 > x0 ? hole_hi + 1 : x0, x1, y, z, color);
+        }
+    }
+}
+
+static inline q16 abs_q16(q16 v) { return v < 0 ? -v : v; }
+
+void disc(Frame &f, const vec3 &c, const vec3 &n, q16 radius, q16 half_thickness, rgb_t color) {
+    const int32_t w = f.width(), h = f.height(), d = f.depth();
+
+    // Half extent of the disc along each axis: radius * sin(angle to the axis) + thickness * |cos|
+    auto extent = [&](q16 na) {
+        return mul(radius, fx::sqrt(K_Q16_ONE - mul(na, na))) + mul(half_thickness, abs_q16(na)) + 1;
+    };
+    int32_t x0, x1, y0, y1, z0, z1;
+    span(c.x, extent(n.x), w, x0, x1);
+    span(c.y, extent(n.y), h, y0, y1);
+    span(c.z, extent(n.z), d, z0, z1);
+
+    const int64_t r2 = (int64_t)radius * radius;
+    for (int32_t z = z0; z <= z1; ++z) {
+        const q16 pz = fx::from_int(z) - c.z;
+        for (int32_t y = y0; y <= y1; ++y) {
+            const q16 py = fx::from_int(y) - c.y;
+            rgb_t *row = f.data() + f.index(0, y, z);
+            for (int32_t x = x0; x <= x1; ++x) {
+                const q16 px = fx::from_int(x) - c.x;
+                // Distance from the plane, then squared distance from the axis within it
+                const q16 dn = fx::dot(vec3{px, py, pz}, n);
+                if (abs_q16(dn) > half_thickness) continue;
+                const int64_t p2 = (int64_t)px * px + (int64_t)py * py + (int64_t)pz * pz;
+                if (p2 - (int64_t)dn * dn > r2) continue;
+                row[x] = color;
+            }
+        }
+    }
+}
+
+static inline int32_t iabs(int32_t v) { return v < 0 ? -v : v; }
+
+void line(Frame &f, ivec3 a, ivec3 b, rgb_t color) {
+    const int32_t w = f.width(), h = f.height(), d = f.depth();
+    int32_t p[3] = {a.x, a.y, a.z};
+    const int32_t delta[3] = {iabs(b.x - a.x), iabs(b.y - a.y), iabs(b.z - a.z)};
+    const int32_t step[3] = {a.x < b.x ? 1 : -1, a.y < b.y ? 1 : -1, a.z < b.z ? 1 : -1};
+
+    // The longest axis advances every voxel; the other two follow their error terms
+    int m = 0;
+    if (delta[1] > delta[m]) m = 1;
+    if (delta[2] > delta[m]) m = 2;
+    const int32_t n = delta[m];
+    int32_t err[3] = {2 * delta[0] - n, 2 * delta[1] - n, 2 * delta[2] - n};
+
+    for (int32_t i = 0; i <= n; ++i) {
+        if (p[0] >= 0 && p[1] >= 0 && p[2] >= 0 && p[0] < w && p[1] < h && p[2] < d) f.at(p[0], p[1], p[2]) = color;
+        for (int k = 0; k < 3; ++k) {
+            if (k == m) continue;
+            if (err[k] > 0) {
+                p[k] += step[k];
+                err[k] -= 2 * n;
+            }
+            err[k] += 2 * delta[k];
+        }
+        p[m] += step[m];
+    }
+}
+
+void ray(Frame &f, const vec3 &origin, const vec3 &dir, q16 length, rgb_t color) {
+    const vec3 end = origin + fx::scale(dir, length);
+    line(f, ivec3{fx::round_int(origin.x), fx::round_int(origin.y), fx::round_int(origin.z)},
+         ivec3{fx::round_int(end.x), fx::round_int(end.y), fx::round_int(end.z)}, color);
+}
+
+void box(Frame &f, ivec3 lo, ivec3 hi, rgb_t color) {
+    const int32_t x0 = lo.x < 0 ? 0 : lo.x, x1 = hi.x >= (int32_t)f.width() ? (int32_t)f.width() - 1 : hi.x;
+    const int32_t y0 = lo.y < 0 ? 0 : lo.y, y1 = hi.y >= (int32_t)f.height() ? (int32_t)f.height() - 1 : hi.y;
+    const int32_t z0 = lo.z < 0 ? 0 : lo.z, z1 = hi.z >= (int32_t)f.depth() ? (int32_t)f.depth() - 1 : hi.z;
+    if (x0 > x1) return;
+    for (int32_t z = z0; z <= z1; ++z)
+        for (int32_t y = y0; y <= y1; ++y)
+            cube::frame_ops::fill(f.data() + f.index(x0, y, z), x1 - x0 + 1, color);
+}
+
+void box_edges(Frame &f, ivec3 lo, ivec3 hi, rgb_t color) {
+    const ivec3 c[8] = {{lo.x, lo.y, lo.z}, {hi.x, lo.y, lo.z}, {lo.x, hi.y, lo.z}, {hi.x, hi.y, lo.z},
+                        {lo.x, lo.y, hi.z}, {hi.x, lo.y, hi.z}, {lo.x, hi.y, hi.z}, {hi.x, hi.y, hi.z}};
+    // Corner i and j share an edge when their indices differ in exactly one bit
+    for (int i = 0; i < 8; ++i)
+        for (int bit = 1; bit < 8; bit <<= 1)
+            if (!(i & bit)) line(f, c[i], c[i | bit], color);
+}
+
+} // namespace raster
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "common.hpp"
+#include "cube.hpp"
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "transition.hpp"
+#include <atomic>
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace render {
+
+using anim_common::IAnimation;
+using cube::Cube;
+using cube::FrameStats;
+using cube::FrameTiming;
+
+#define K_RENDER_TASK_STACK 4096
+#define K_RENDER_TASK_PRIO 5
+// With CUBE_PROFILING, the render task prints per-animation frame timing this often
+#define K_RENDER_STATS_INTERVAL_US (10 * 1000 * 1000)
+
+// Runs the active animation in its own FreeRTOS task at a fixed frame rate.
+// Each frame is step() -> cube.show() -> prefetch() -> sleep until the next deadline, with
+// deadlines kept in esp_timer microseconds and advanced by one period, so neither render
+// cost nor the tick length stretches the period. A frame starts on the first tick at or after
+// its deadline, so it can be up to one tick late (1 ms with sdkconfig.defaults' 1 kHz tick).
+// Animation switches requested from other tasks wake the render task and
+// take effect at the next frame boundary, through a transition (see TransitionEngine):
+// while it lasts both animations render each frame, at the incoming animation's rate.
+class RenderScheduler {
+  public:
+    RenderScheduler(Cube &cube, IAnimation *const *animations, size_t count);
+    RenderScheduler(const RenderScheduler &) = delete;
+    RenderScheduler &operator=(const RenderScheduler &) = delete;
+
+    // Spawn the render task; init()s the first animation on that task.
+    esp_err_t start(UBaseType_t priority = K_RENDER_TASK_PRIO, uint32_t stack_size = K_RENDER_TASK_STACK);
+
+    // Thread-safe, not ISR-safe: switch animations at the next frame boundary, waking the
+    // render task if it is sleeping.
+    void next();
+    void select(size_t index);
+
+    // Force a frame rate for every animation; 0 (default) uses each animation's frame_period_ms().
+    void set_target_fps(uint32_t fps) {
+        fixed_period_us_.store(fps ? 1000000 / fps : 0, std::memory_order_relaxed);
+    }
+    // Thread-safe: how later switches look. TransitionKind::Cut or 0 frames switches at once.
+    void set_transition(TransitionKind kind, uint32_t frames) {
+        transition_kind_.store(static_cast<uint8_t>(kind), std::memory_order_relaxed);
+        transition_frames_.store(frames, std::memory_order_relaxed);
+    }
+
+    size_t current_index() const { return current_.load(std::memory_order_relaxed); }
+    uint32_t frames() const { return frames_.load(std::memory_order_relaxed); }
+    // Frames that finished a whole period after their deadline, since start()
+    uint32_t missed_deadlines() const { return missed_.load(std::memory_order_relaxed); }
+
+    // Per-animation render/wait/encode/idle timings; empty unless built with CUBE_PROFILING.
+    // The render task writes these, so reads from other tasks are best-effort.
+    const FrameStats &stats(size_t index) const { return stats_[index]; }
+    void dump_stats() const;
+
+  private:
+    static void task_entry(void *arg);
+    void run();
+    void activate(size_t index);
+    // True if `index` was init()ed straight into the cube, false if a transition started
+    bool switch_to(size_t index);
+    uint32_t period_us() const;
+
+    Cube &cube_;
+    IAnimation *const *animations_;
+    size_t count_;
+    TaskHandle_t task_ = nullptr;
+
+    std::atomic<size_t> current_{0};
+    std::atomic<int32_t> pending_{-1}; // index requested by next()/select(), -1 = none
+    std::atomic<uint32_t> fixed_period_us_{0};
+    std::atomic<uint32_t> frames_{0};
+    std::atomic<uint32_t> missed_{0};
+    std::atomic<uint8_t> transition_kind_{static_cast<uint8_t>(TransitionKind::CrossFade)};
+    std::atomic<uint32_t> transition_frames_{K_RENDER_TRANSITION_FRAMES};
+    TransitionEngine transition_; // render task only
+    std::unique_ptr<FrameStats[]> stats_;
+};
+
+} // namespace render
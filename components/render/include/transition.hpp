@@ -0,0 +1,52 @@
+#pragma once
+
+#include "common.hpp"
+#include "cube.hpp"
+#include <stdint.h>
+
+namespace render {
+
+using anim_common::IAnimation;
+using cube::Cube;
+using cube::Frame;
+
+// Default length of the render scheduler's transitions
+#define K_RENDER_TRANSITION_FRAMES 12
+
+enum class TransitionKind : uint8_t {
+    Cut,       // switch at once
+    CrossFade, // blend from the outgoing to the incoming animation
+    WipeX,     // the incoming animation sweeps in along +x
+    WipeY,     // ... along +y
+    WipeZ,     // ... along +z
+};
+
+// Switches animations gradually. For the length of a transition both animations keep running,
+// each into its own off-screen frame, and every frame of the cube mixes the two. The outgoing
+// animation's frame is taken from the cube's back buffer and, at the end, the incoming one's
+// frame becomes the back buffer, both by swapping rather than copying.
+class TransitionEngine {
+  public:
+    bool active() const { return to_ != nullptr; }
+
+    // Start moving from `from`, which has been rendering into the cube's back buffer, to `to`,
+    // which is init()ed here. Takes `frames` frames (at least 1).
+    void begin(Cube &cube, IAnimation *from, IAnimation *to, TransitionKind kind, uint32_t frames);
+    // Step both animations and mix them into the back buffer. On the last frame the incoming
+    // animation takes over the back buffer and the transition ends.
+    void step(Cube &cube, uint32_t dt_ms);
+    // End the transition now, as if its last frame had been rendered
+    void finish(Cube &cube);
+    void prefetch();
+
+  private:
+    IAnimation *from_ = nullptr;
+    IAnimation *to_ = nullptr;
+    TransitionKind kind_ = TransitionKind::Cut;
+    uint32_t frames_ = 0;
+    uint32_t frame_ = 0;
+    Frame out_; // the outgoing animation's target
+    Frame in_;  // the incoming animation's target
+};
+
+} // namespace render
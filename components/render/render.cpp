@@ -0,0 +1,154 @@
+#include "render.hpp"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+namespace render {
+
+static const char *TAG = "render";
+
+// Rate limit for the missed-deadline warning
+#define K_MISS_LOG_INTERVAL_US (1000 * 1000)
+#define K_TICK_US (1000 * portTICK_PERIOD_MS)
+
+RenderScheduler::RenderScheduler(Cube &cube, IAnimation *const *animations, size_t count)
+    : cube_(cube), animations_(animations), count_(count), stats_(new FrameStats[count]) {
+    assert(animations_ != nullptr && count_ > 0);
+}
+
+esp_err_t RenderScheduler::start(UBaseType_t priority, uint32_t stack_size) {
+    if (task_) return ESP_ERR_INVALID_STATE;
+    if (xTaskCreate(task_entry, "render", stack_size, this, priority, &task_) != pdPASS) return ESP_ERR_NO_MEM;
+    return ESP_OK;
+}
+
+void RenderScheduler::next() {
+    // Chain off a still-pending request so quick presses are not lost
+    int32_t pending = pending_.load(std::memory_order_relaxed);
+    const size_t from = pending >= 0 ? static_cast<size_t>(pending) : current_.load(std::memory_order_relaxed);
+    select((from + 1) % count_);
+}
+
+void RenderScheduler::select(size_t index) {
+    if (index >= count_) return;
+    pending_.store(static_cast<int32_t>(index), std::memory_order_release);
+    // Cut the render task's sleep short so the switch starts with the next frame
+    if (task_) xTaskNotifyGive(task_);
+}
+
+void RenderScheduler::dump_stats() const {
+    for (size_t i = 0; i < count_; ++i) {
+        if (stats_[i].count() == 0) continue;
+        stats_[i].dump(animations_[i]->name());
+    }
+}
+
+void RenderScheduler::task_entry(void *arg) { static_cast<RenderScheduler *>(arg)->run(); }
+
+void RenderScheduler::activate(size_t index) {
+    current_.store(index, std::memory_order_relaxed);
+    animations_[index]->init(cube_.frame());
+}
+
+bool RenderScheduler::switch_to(size_t index) {
+    const size_t from = current_.load(std::memory_order_relaxed);
+    const auto kind = static_cast<TransitionKind>(transition_kind_.load(std::memory_order_relaxed));
+    const uint32_t frames = transition_frames_.load(std::memory_order_relaxed);
+    // A transition runs two animations side by side, so it needs two distinct ones
+    if (kind == TransitionKind::Cut || frames == 0 || index == from) {
+        transition_.finish(cube_);
+        activate(index);
+        return true;
+    }
+    // A switch during a transition starts from the animation that was coming in
+    transition_.begin(cube_, animations_[from], animations_[index], kind, frames);
+    current_.store(index, std::memory_order_relaxed);
+    return false;
+}
+
+uint32_t RenderScheduler::period_us() const {
+    const uint32_t fixed = fixed_period_us_.load(std::memory_order_relaxed);
+    const uint32_t us = fixed ? fixed : animations_[current_.load(std::memory_order_relaxed)]->frame_period_ms() * 1000;
+    return us ? us : 1000;
+}
+
+void RenderScheduler::run() {
+    activate(current_.load(std::memory_order_relaxed));
+
+    int64_t last_frame_us = esp_timer_get_time();
+    int64_t deadline_us = last_frame_us;
+    uint32_t dt_ms = 0;
+    int64_t last_miss_log_us = 0;
+    uint32_t missed_at_last_log = 0;
+    CUBE_PROF(int64_t last_stats_dump_us = last_frame_us);
+
+    while (true) {
+        const int32_t pending = pending_.exchange(-1, std::memory_order_acquire);
+        if (pending >= 0 && switch_to(static_cast<size_t>(pending))) dt_ms = 0;
+
+        const size_t index = current_.load(std::memory_order_relaxed);
+        IAnimation *anim = animations_[index];
+        CUBE_PROF(const int64_t t_step = CUBE_PROF_NOW());
+        if (transition_.active()) {
+            transition_.step(cube_, dt_ms);
+        } else {
+            anim->step(cube_.frame(), dt_ms);
+        }
+        CUBE_PROF(const int64_t t_show = CUBE_PROF_NOW());
+        ESP_ERROR_CHECK(cube_.show());
+        CUBE_PROF(const int64_t t_sleep = CUBE_PROF_NOW());
+        frames_.fetch_add(1, std::memory_order_relaxed);
+        if (transition_.active()) {
+            transition_.prefetch();
+        } else {
+            anim->prefetch();
+        }
+
+        // Deadlines are esp_timer times one period apart, so the rate is the requested one on
+        // average however coarse the tick: a sleep ends on a tick at or after its deadline,
+        // and the next deadline is still one period after this one, not after the wake-up.
+        const int64_t period = period_us();
+        deadline_us += period;
+        int64_t now = esp_timer_get_time();
+        if (now - deadline_us >= period) {
+            // A whole period behind: count it and re-anchor so we do not burst to catch up
+            missed_.fetch_add(1, std::memory_order_relaxed);
+            deadline_us = now;
+        }
+        while (now < deadline_us) {
+            const TickType_t ticks = static_cast<TickType_t>((deadline_us - now + K_TICK_US - 1) / K_TICK_US);
+            if (ulTaskNotifyTake(pdTRUE, ticks) > 0) {
+                // Woken by a switch request: render it now and restart the frame clock from here
+                now = esp_timer_get_time();
+                deadline_us = now;
+                break;
+            }
+            now = esp_timer_get_time();
+        }
+
+        CUBE_PROF({
+            FrameTiming t = cube_.last_timing();
+            t.render_us = static_cast<uint32_t>(t_show - t_step);
+            t.idle_us = static_cast<uint32_t>(now - t_sleep);
+            stats_[index].record(t);
+            if (now - last_stats_dump_us >= K_RENDER_STATS_INTERVAL_US) {
+                dump_stats();
+                last_stats_dump_us = now;
+            }
+        });
+        // Whole milliseconds; the rest carries into the next frame's dt_ms, so animations that
+        // integrate it keep up with wall time
+        dt_ms = static_cast<uint32_t>((now - last_frame_us) / 1000);
+        last_frame_us += (int64_t)dt_ms * 1000;
+
+        const uint32_t missed = missed_.load(std::memory_order_relaxed);
+        if (missed != missed_at_last_log && now - last_miss_log_us >= K_MISS_LOG_INTERVAL_US) {
+            ESP_LOGW(TAG, "animation %u missed %lu frame deadline(s) (period %lu ms)",
+                     (unsigned)current_.load(std::memory_order_relaxed), (unsigned long)(missed - missed_at_last_log),
+                     (unsigned long)(period_us() / 1000));
+            missed_at_last_log = missed;
+            last_miss_log_us = now;
+        }
+    }
+}
+
+} // namespace render
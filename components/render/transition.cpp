@@ -0,0 +1,81 @@
+#include "transition.hpp"
+#include <string.h>
+
+namespace render {
+
+// dst = b where the coordinate along the wipe axis is below `edge`, a elsewhere
+static void wipe(Frame &dst, const Frame &a, const Frame &b, TransitionKind kind, uint32_t edge) {
+    const uint32_t W = dst.width(), H = dst.height(), D = dst.depth();
+    const size_t face = (size_t)W * H * sizeof(cube::rgb_t);
+    const size_t row = (size_t)W * sizeof(cube::rgb_t);
+    for (uint32_t z = 0; z < D; ++z) {
+        if (kind == TransitionKind::WipeZ) {
+            memcpy(dst.layer(z), (z < edge ? b : a).layer(z), face);
+            continue;
+        }
+        for (uint32_t y = 0; y < H; ++y) {
+            const size_t i = dst.index(0, y, z);
+            if (kind == TransitionKind::WipeY) {
+                memcpy(dst.data() + i, (y < edge ? b : a).data() + i, row);
+                continue;
+            }
+            const uint32_t split = edge < W ? edge : W;
+            memcpy(dst.data() + i, b.data() + i, split * sizeof(cube::rgb_t));
+            memcpy(dst.data() + i + split, a.data() + i + split, (W - split) * sizeof(cube::rgb_t));
+        }
+    }
+}
+
+void TransitionEngine::begin(Cube &cube, IAnimation *from, IAnimation *to, TransitionKind kind, uint32_t frames) {
+    if (active()) finish(cube);
+    out_.resize(cube.width(), cube.height(), cube.depth());
+    in_.resize(cube.width(), cube.height(), cube.depth());
+    // The outgoing animation keeps drawing on its own last frame
+    cube.swap_frame(out_);
+    from_ = from;
+    to_ = to;
+    kind_ = kind;
+    frames_ = frames ? frames : 1;
+    frame_ = 0;
+    to_->init(in_);
+}
+
+void TransitionEngine::step(Cube &cube, uint32_t dt_ms) {
+    if (!active()) return;
+    from_->step(out_, dt_ms);
+    to_->step(in_, frame_ == 0 ? 0 : dt_ms); // its first frame since init()
+    if (++frame_ >= frames_) {
+        finish(cube);
+        return;
+    }
+
+    Frame &dst = cube.frame();
+    if (kind_ == TransitionKind::CrossFade || kind_ == TransitionKind::Cut) {
+        const cube::BlendLayer layers[2] = {
+            {reinterpret_cast<const uint8_t *>(out_.data()), cube::BlendMode::Alpha, 255},
+            {reinterpret_cast<const uint8_t *>(in_.data()), cube::BlendMode::Alpha,
+             static_cast<uint8_t>(frame_ * 255 / frames_)},
+        };
+        dst.composite(layers, 2);
+        return;
+    }
+    uint32_t n = dst.depth();
+    if (kind_ == TransitionKind::WipeX) n = dst.width();
+    if (kind_ == TransitionKind::WipeY) n = dst.height();
+    wipe(dst, out_, in_, kind_, (frame_ * n + frames_ - 1) / frames_);
+}
+
+void TransitionEngine::finish(Cube &cube) {
+    if (!active()) return;
+    cube.swap_frame(in_);
+    from_ = nullptr;
+    to_ = nullptr;
+}
+
+void TransitionEngine::prefetch() {
+    if (!active()) return;
+    from_->prefetch();
+    to_->prefetch();
+}
+
+} // namespace render
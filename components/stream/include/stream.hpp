@@ -0,0 +1,195 @@
+#pragma once
+
+#include "common.hpp"
+#include "esp_err.h"
+#include "frame.hpp"
+#include "seqlock.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+// Frames streamed from another machine (a PC renderer) over UDP, received straight into
+// slot buffers and presented in sequence order after a short jitter buffer.
+//
+// Every datagram is one fragment of one frame (little endian):
+//   0  "AUST"
+//   4  u8  version (K_STREAM_VERSION)
+//   5  u8  frame type (StreamFrameType)
+//   6  u8  fragment index, u8 fragment count (1..K_STREAM_MAX_FRAGMENTS)
+//   8  u32 frame sequence number, +1 per frame
+//   12 u32 presentation time, µs on the sender's clock (wraps)
+//   16 u32 Raw: byte offset of the payload in the frame; Delta: voxel the first span starts at
+//   20 payload, at most K_STREAM_MAX_PAYLOAD bytes
+//
+// A Raw payload is frame bytes (r, g, b per voxel in Frame order). A Delta payload is a list
+// of spans over the frame before it (sequence - 1): u16 voxels to leave unchanged, u8 count,
+// then count r, g, b triplets. Senders split frames so that every voxel of a Raw frame is
+// covered once, keep the payloads of a Delta frame within the size of a Raw one (the receiver
+// holds them in a frame buffer until the frame is shown), and send a Raw frame now and then
+// so a receiver that lost one can resync.
+namespace stream {
+
+using anim_common::IAnimation;
+using cube::Frame;
+
+#define K_STREAM_MAGIC "AUST"
+#define K_STREAM_VERSION 1
+#define K_STREAM_HEADER_BYTES 20
+// Keeps a datagram inside a 1500-byte Ethernet MTU with IPv4 and UDP headers
+#define K_STREAM_MAX_PAYLOAD 1452
+#define K_STREAM_MAX_FRAGMENTS 32
+#define K_STREAM_DEFAULT_PORT 7777
+// Frames held between reception and presentation
+#define K_STREAM_SLOTS 4
+// A frame still missing fragments this long after its first one arrived is given up on
+#define K_STREAM_REASSEMBLY_US (100 * 1000)
+// Frames are shown this long after the earliest their timing allows, to absorb network jitter
+#define K_STREAM_JITTER_US (20 * 1000)
+// The sender-to-receiver clock offset is re-estimated over this many frames, so that clock
+// drift and route changes are followed
+#define K_STREAM_OFFSET_WINDOW 128
+// Senders should send a Raw frame at least this often (in frames): after a lost frame the
+// receiver shows nothing new until the next one
+#define K_STREAM_KEY_INTERVAL 8
+// StreamAnim polls the socket at this period: the wire time of an 8x8x8 cube on two chains.
+// The render task wakes on ticks, so each poll is up to one tick late; sdkconfig.defaults
+// sets a 1 kHz tick to keep that under 1 ms (at 100 Hz polls would land 10 ms apart or worse).
+#define K_STREAM_POLL_MS 8
+
+enum class StreamFrameType : uint8_t { Raw = 0, Delta = 1 };
+
+// Counters since open(). Throughput is bytes (or frames_presented) over time; latency is
+// from the arrival of a frame's first fragment to its presentation, jitter buffer included.
+struct StreamStats {
+    uint32_t datagrams;
+    uint32_t bytes; // payload and header
+    uint32_t malformed;          // datagrams with a bad header or payload
+    uint32_t stale;              // datagrams for frames already presented or given up on
+    uint32_t frames_presented;
+    uint32_t frames_skipped;     // complete, but a newer frame was due at the same time
+    uint32_t frames_incomplete;  // fragments still missing when the frame was given up on
+    uint32_t frames_undecodable; // delta frames whose base frame never became available
+    uint32_t frames_lost;        // sequence numbers never seen at all
+    uint32_t latency_us;         // of the last presented frame
+    uint32_t latency_max_us;
+    uint32_t jitter_us; // smoothed variation of frame transit time (RFC 3550 style)
+    uint32_t last_sequence; // of the last presented frame
+};
+
+// Receives the stream on a UDP port. Single-threaded: poll() and present() must be called
+// from the same task (normally the render task, through StreamAnim); stats() may be read
+// from anywhere.
+class StreamReceiver {
+  public:
+    StreamReceiver(uint32_t width, uint32_t height, uint32_t depth);
+    ~StreamReceiver();
+    StreamReceiver(const StreamReceiver &) = delete;
+    StreamReceiver &operator=(const StreamReceiver &) = delete;
+
+    // Bind the UDP port (on every interface) and reset the stream state
+    esp_err_t open(uint16_t port = K_STREAM_DEFAULT_PORT, uint32_t jitter_us = K_STREAM_JITTER_US);
+    void close();
+    bool is_open() const { return sock_ >= 0; }
+    // Drop every buffered frame and the timing estimates; the counters carry on
+    void reset();
+
+    // Take every datagram that is waiting, without blocking. Every payload is received
+    // straight into its slot: Raw fragments into the slot's frame at their offset, delta
+    // payloads into the same memory as they come, to be decoded when the frame is presented.
+    void poll();
+
+    // If a frame is due at `now_us`, bring `target` (same geometry) to it and return true.
+    // A Raw frame is swapped in and the frame `target` held goes back to the slot pool; a
+    // delta's spans are copied onto `target`, which must therefore still hold the frame
+    // presented last. Those spans are the only bytes copied on the way to the screen.
+    bool present(Frame &target, int64_t now_us);
+
+    void stats(StreamStats &out) const { stats_pub_.read(out); }
+
+  private:
+    // Complete: every fragment is in; a delta may still be waiting for the frame before it.
+    // Dead: a bad fragment spoiled the frame; its remaining fragments are discarded.
+    enum class SlotState : uint8_t { Free, Receiving, Complete, Dead };
+    struct Slot {
+        // Delta: where each fragment's payload is stored in frame, and the voxel it starts at
+        struct Part {
+            uint32_t voxel;
+            uint16_t at;
+            uint16_t bytes;
+        };
+        static_assert(K_STREAM_MAX_FRAGMENTS * K_STREAM_MAX_PAYLOAD <= 0xFFFF, "Part offsets are 16-bit");
+        Frame frame; // Raw: the frame; Delta: the payloads of its fragments, back to back
+        SlotState state = SlotState::Free;
+        uint32_t seq = 0;
+        uint32_t fragments = 0; // bitmask of fragments received
+        uint8_t fragment_count = 0;
+        StreamFrameType type = StreamFrameType::Raw;
+        size_t filled = 0; // payload bytes received
+        Part parts[K_STREAM_MAX_FRAGMENTS];
+        int64_t first_arrival_us = 0;
+        int64_t pts_us = 0; // unwrapped sender time
+        int64_t due_us = 0; // local presentation time, set when complete
+    };
+
+    void receive_one(const uint8_t *hdr, size_t peeked);
+    void discard();
+    Slot *slot_for(uint32_t seq, StreamFrameType type, uint8_t fragment_count, uint32_t pts, int64_t now_us);
+    Slot *complete_slot(uint32_t seq);
+    // A Raw frame, or a delta whose frames back to the one last presented, or to a Raw
+    // frame, are all complete
+    bool decodable(const Slot &slot);
+    void apply_delta(const Slot &slot, Frame &target);
+    void complete(Slot &slot, int64_t now_us);
+    // Give up on a slot's frame, counting it by the state it got to
+    void drop(Slot &slot);
+    void publish() { stats_pub_.write(stats_); }
+
+    uint32_t width_, height_, depth_;
+    int sock_ = -1;
+    uint32_t jitter_us_ = K_STREAM_JITTER_US;
+    Slot slots_[K_STREAM_SLOTS];
+    uint8_t scratch_[K_STREAM_HEADER_BYTES + K_STREAM_MAX_PAYLOAD]; // datagrams discarded
+
+    bool started_ = false; // a frame has been seen since open()
+    uint32_t highest_seq_ = 0;
+    uint64_t seen_ = 0; // bit i: a slot was opened for frame highest_seq_ - i
+    uint32_t presented_seq_ = 0;
+    bool presented_any_ = false;
+    uint32_t last_pts_ = 0; // newest presentation time seen, as sent
+    int64_t pts_base_ = 0;  // the same, unwrapped
+
+    // Receiver clock minus sender clock: the smallest transit seen, so the fastest frame
+    // defines "no delay"; a new minimum is taken over each window
+    int64_t offset_us_ = 0;
+    int64_t window_min_us_ = INT64_MAX;
+    uint32_t window_frames_ = 0;
+    bool have_offset_ = false;
+    int64_t last_transit_us_ = 0;
+    int64_t jitter_est_us_ = 0;
+
+    StreamStats stats_ = {};
+    utils::Seqlock<StreamStats> stats_pub_;
+};
+
+// Plays the stream as an animation: each step takes waiting datagrams and presents the frame
+// that is due. Steps run every K_STREAM_POLL_MS (within a tick), so a stream up to the cube's
+// refresh rate is shown at its own rate. Dark until the first frame arrives.
+class StreamAnim : public IAnimation {
+  public:
+    StreamAnim(const char *name, uint32_t width, uint32_t height, uint32_t depth,
+               uint16_t port = K_STREAM_DEFAULT_PORT)
+        : name_(name), port_(port), rx_(width, height, depth) {}
+
+    void init(Frame &target) override;
+    void step(Frame &target, uint32_t dt_ms) override;
+    uint32_t frame_period_ms() const override { return K_STREAM_POLL_MS; }
+    const char *name() const override { return name_; }
+
+    StreamReceiver &receiver() { return rx_; }
+
+  private:
+    const char *name_;
+    uint16_t port_;
+    StreamReceiver rx_;
+};
+
+} // namespace stream
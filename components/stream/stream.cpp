@@ -0,0 +1,375 @@
+#include "stream.hpp"
+#include "esp_timer.h"
+#include <netinet/in.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <utility>
+
+namespace stream {
+
+static inline uint16_t rd16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static inline uint32_t rd32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+// Sequence numbers wrap: a is after b if it is less than half the number space ahead
+static inline bool seq_after(uint32_t a, uint32_t b) { return (int32_t)(a - b) > 0; }
+
+// Walk the spans of one Delta payload starting at `voxel`, copying them into `dst` unless it
+// is null; false if they are malformed or run past the frame's `voxels`
+static bool copy_spans(const uint8_t *p, size_t n, size_t voxel, size_t voxels, uint8_t *dst) {
+    size_t v = voxel;
+    const uint8_t *end = p + n;
+    while (p < end) {
+        if (end - p < 3) return false;
+        v += rd16(p);
+        const size_t count = p[2];
+        p += 3;
+        if (count == 0 || v + count > voxels || (size_t)(end - p) < count * 3) return false;
+        if (dst) memcpy(dst + v * 3, p, count * 3);
+        p += count * 3;
+        v += count;
+    }
+    return true;
+}
+
+StreamReceiver::StreamReceiver(uint32_t width, uint32_t height, uint32_t depth)
+    : width_(width), height_(height), depth_(depth) {}
+
+StreamReceiver::~StreamReceiver() { close(); }
+
+esp_err_t StreamReceiver::open(uint16_t port, uint32_t jitter_us) {
+    if (sock_ >= 0) return ESP_ERR_INVALID_STATE;
+    const size_t bytes = (size_t)width_ * height_ * depth_ * sizeof(utils::rgb_t);
+    if (bytes > (size_t)K_STREAM_MAX_FRAGMENTS * K_STREAM_MAX_PAYLOAD) return ESP_ERR_INVALID_SIZE;
+
+    const int s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (s < 0) return ESP_FAIL;
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(s, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0) {
+        ::close(s);
+        return ESP_FAIL;
+    }
+
+    for (Slot &slot : slots_)
+        slot.frame.resize(width_, height_, depth_);
+    sock_ = s;
+    jitter_us_ = jitter_us;
+    stats_ = StreamStats{};
+    reset();
+    return ESP_OK;
+}
+
+void StreamReceiver::close() {
+    if (sock_ < 0) return;
+    ::close(sock_);
+    sock_ = -1;
+}
+
+void StreamReceiver::reset() {
+    for (Slot &slot : slots_)
+        slot.state = SlotState::Free;
+    started_ = false;
+    presented_any_ = false;
+    have_offset_ = false;
+    window_min_us_ = INT64_MAX;
+    window_frames_ = 0;
+    jitter_est_us_ = 0;
+    publish();
+}
+
+void StreamReceiver::poll() {
+    if (sock_ < 0) return;
+    uint8_t hdr[K_STREAM_HEADER_BYTES];
+    while (true) {
+        // Look at the header first, so a Raw payload can be received straight into its frame
+        const ssize_t n = recv(sock_, hdr, sizeof(hdr), MSG_PEEK | MSG_DONTWAIT);
+        if (n < 0) break;
+        receive_one(hdr, (size_t)n);
+    }
+    publish();
+}
+
+void StreamReceiver::discard() {
+    const ssize_t n = recv(sock_, scratch_, sizeof(scratch_), MSG_DONTWAIT);
+    if (n > 0) stats_.bytes += (uint32_t)n;
+}
+
+void StreamReceiver::receive_one(const uint8_t *hdr, size_t peeked) {
+    const int64_t now = esp_timer_get_time();
+    ++stats_.datagrams;
+    if (peeked < K_STREAM_HEADER_BYTES || memcmp(hdr, K_STREAM_MAGIC, 4) != 0 || hdr[4] != K_STREAM_VERSION ||
+        hdr[5] > (uint8_t)StreamFrameType::Delta || hdr[7] == 0 || hdr[7] > K_STREAM_MAX_FRAGMENTS ||
+        hdr[6] >= hdr[7]) {
+        ++stats_.malformed;
+        discard();
+        return;
+    }
+    const StreamFrameType type = static_cast<StreamFrameType>(hdr[5]);
+    const uint8_t fragment = hdr[6];
+    const uint32_t seq = rd32(hdr + 8);
+    const uint32_t offset = rd32(hdr + 16);
+
+    Slot *slot = slot_for(seq, type, hdr[7], rd32(hdr + 12), now);
+    if (!slot || (slot->fragments & (1u << fragment))) {
+        if (slot) ++stats_.stale; // duplicate
+        discard();
+        return;
+    }
+
+    // Header into a throwaway buffer, payload into the slot's frame memory: a Raw payload at
+    // its offset, a Delta payload after those of the frame already received, where it stays
+    // until present() applies it
+    uint8_t *const store = reinterpret_cast<uint8_t *>(slot->frame.data());
+    const size_t bytes = slot->frame.bytes();
+    const size_t at = type == StreamFrameType::Raw ? offset : slot->filled;
+    if (at >= bytes && type == StreamFrameType::Raw) {
+        ++stats_.malformed;
+        discard();
+        return;
+    }
+    uint8_t header[K_STREAM_HEADER_BYTES];
+    iovec iov[2] = {{header, sizeof(header)}, {store + at, bytes - at}};
+    msghdr msg = {};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
+    const ssize_t n = recvmsg(sock_, &msg, MSG_DONTWAIT);
+    if (n < 0) return;
+    stats_.bytes += (uint32_t)n;
+    const size_t len = n > K_STREAM_HEADER_BYTES ? (size_t)n - K_STREAM_HEADER_BYTES : 0;
+    bool ok = n >= K_STREAM_HEADER_BYTES && !(msg.msg_flags & MSG_TRUNC);
+    if (type == StreamFrameType::Raw)
+        ok = ok && len > 0;
+    else
+        ok = ok && copy_spans(store + at, len, offset, slot->frame.voxels(), nullptr);
+    if (ok) {
+        slot->parts[fragment] = Slot::Part{offset, static_cast<uint16_t>(at), static_cast<uint16_t>(len)};
+        slot->filled += len;
+    }
+    if (!ok) {
+        // A bad fragment spoils the frame it belongs to
+        ++stats_.malformed;
+        drop(*slot);
+        slot->state = SlotState::Dead;
+        return;
+    }
+
+    slot->fragments |= 1u << fragment;
+    if (slot->fragments == (slot->fragment_count == 32 ? 0xFFFFFFFFu : (1u << slot->fragment_count) - 1)) {
+        if (type == StreamFrameType::Raw && slot->filled != slot->frame.bytes()) {
+            ++stats_.malformed;
+            drop(*slot);
+            slot->state = SlotState::Dead;
+            return;
+        }
+        complete(*slot, now);
+    }
+}
+
+StreamReceiver::Slot *StreamReceiver::slot_for(uint32_t seq, StreamFrameType type, uint8_t fragment_count,
+                                               uint32_t pts, int64_t now_us) {
+    if (presented_any_ && !seq_after(seq, presented_seq_)) {
+        ++stats_.stale;
+        return nullptr;
+    }
+    for (Slot &slot : slots_) {
+        if (slot.state == SlotState::Free || slot.seq != seq) continue;
+        if (slot.state == SlotState::Dead) return nullptr;
+        if (slot.type != type || slot.fragment_count != fragment_count) {
+            ++stats_.malformed;
+            return nullptr;
+        }
+        return &slot;
+    }
+
+    // A new frame: account for any sequence numbers it skipped
+    if (!started_) {
+        started_ = true;
+        highest_seq_ = seq - 1;
+        seen_ = ~0ull; // nothing from before the stream started counts as lost
+        last_pts_ = pts;
+        pts_base_ = pts;
+    }
+    if (seq_after(seq, highest_seq_)) {
+        const uint32_t gap = seq - highest_seq_;
+        stats_.frames_lost += gap - 1;
+        seen_ = (gap >= 64 ? 0 : seen_ << gap) | 1;
+        highest_seq_ = seq;
+    } else {
+        // Reordered rather than lost after all, if it was counted as lost; a frame that
+        // already had a slot was given up on and stays given up on
+        const uint32_t back = highest_seq_ - seq;
+        if (back >= 64 || (seen_ & (1ull << back))) {
+            ++stats_.stale;
+            return nullptr;
+        }
+        seen_ |= 1ull << back;
+        --stats_.frames_lost;
+    }
+
+    // A free slot, or else the oldest frame, unless the new one is older still
+    Slot *slot = nullptr;
+    for (Slot &s : slots_) {
+        if (s.state == SlotState::Free) {
+            slot = &s;
+            break;
+        }
+        if (!slot || seq_after(slot->seq, s.seq)) slot = &s;
+    }
+    if (slot->state != SlotState::Free) {
+        if (seq_after(slot->seq, seq)) {
+            ++stats_.frames_incomplete;
+            return nullptr;
+        }
+        drop(*slot);
+    }
+
+    // Unwrap the sender's 32-bit clock around the newest time seen
+    const int32_t ahead = (int32_t)(pts - last_pts_);
+    slot->pts_us = pts_base_ + ahead;
+    if (ahead > 0) {
+        last_pts_ = pts;
+        pts_base_ = slot->pts_us;
+    }
+
+    slot->seq = seq;
+    slot->type = type;
+    slot->fragment_count = fragment_count;
+    slot->fragments = 0;
+    slot->filled = 0;
+    slot->first_arrival_us = now_us;
+    slot->state = SlotState::Receiving;
+    return slot;
+}
+
+StreamReceiver::Slot *StreamReceiver::complete_slot(uint32_t seq) {
+    for (Slot &slot : slots_)
+        if (slot.state == SlotState::Complete && slot.seq == seq) return &slot;
+    return nullptr;
+}
+
+bool StreamReceiver::decodable(const Slot &slot) {
+    const Slot *s = &slot;
+    while (s->type == StreamFrameType::Delta) {
+        if (presented_any_ && s->seq - 1 == presented_seq_) return true;
+        s = complete_slot(s->seq - 1);
+        if (!s) return false;
+    }
+    return true;
+}
+
+void StreamReceiver::apply_delta(const Slot &slot, Frame &target) {
+    const uint8_t *store = reinterpret_cast<const uint8_t *>(slot.frame.data());
+    uint8_t *dst = reinterpret_cast<uint8_t *>(target.data());
+    for (uint8_t i = 0; i < slot.fragment_count; ++i) {
+        const Slot::Part &part = slot.parts[i];
+        copy_spans(store + part.at, part.bytes, part.voxel, target.voxels(), dst);
+    }
+}
+
+void StreamReceiver::complete(Slot &slot, int64_t now_us) {
+    slot.state = SlotState::Complete;
+
+    // Transit time on mixed clocks; only its changes and its minimum mean anything
+    const int64_t transit = now_us - slot.pts_us;
+    if (!have_offset_ || transit < offset_us_) offset_us_ = transit;
+    if (have_offset_) {
+        const int64_t d = transit - last_transit_us_;
+        jitter_est_us_ += ((d < 0 ? -d : d) - jitter_est_us_) / 16;
+    }
+    have_offset_ = true;
+    last_transit_us_ = transit;
+    if (transit < window_min_us_) window_min_us_ = transit;
+    if (++window_frames_ >= K_STREAM_OFFSET_WINDOW) {
+        offset_us_ = window_min_us_;
+        window_min_us_ = INT64_MAX;
+        window_frames_ = 0;
+    }
+    slot.due_us = slot.pts_us + offset_us_ + jitter_us_;
+}
+
+void StreamReceiver::drop(Slot &slot) {
+    if (slot.state == SlotState::Complete) ++stats_.frames_skipped;
+    if (slot.state == SlotState::Receiving) ++stats_.frames_incomplete;
+    slot.state = SlotState::Free;
+}
+
+bool StreamReceiver::present(Frame &target, int64_t now_us) {
+    const int64_t give_up_us = K_STREAM_REASSEMBLY_US + (int64_t)jitter_us_;
+    // Fragments that never came, and dead frames, only hold slots up
+    for (Slot &slot : slots_)
+        if ((slot.state == SlotState::Receiving || slot.state == SlotState::Dead) &&
+            now_us - slot.first_arrival_us > give_up_us)
+            drop(slot);
+    // So does a delta whose base frame was given up on; one whose base is still arriving
+    // waits for it as long as an incomplete frame waits for its fragments
+    for (Slot &slot : slots_) {
+        if (slot.state == SlotState::Complete && now_us - slot.first_arrival_us > give_up_us && !decodable(slot)) {
+            ++stats_.frames_undecodable;
+            slot.state = SlotState::Free;
+        }
+    }
+
+    Slot *due = nullptr;
+    for (Slot &slot : slots_)
+        if (slot.state == SlotState::Complete && slot.due_us <= now_us && (!due || seq_after(slot.seq, due->seq)) &&
+            decodable(slot))
+            due = &slot;
+    if (!due) return false;
+    const uint32_t seq = due->seq;
+    const int64_t first_arrival_us = due->first_arrival_us;
+
+    // Build it in sequence order from the frame `target` shows, or from the newest Raw frame
+    // before it: a Raw frame is swapped in, a delta's spans are copied onto what is there
+    Slot *chain[K_STREAM_SLOTS];
+    size_t links = 0;
+    for (Slot *s = due;; s = complete_slot(s->seq - 1)) {
+        chain[links++] = s;
+        if (s->type == StreamFrameType::Raw || (presented_any_ && s->seq - 1 == presented_seq_)) break;
+    }
+    while (links--) {
+        Slot &s = *chain[links];
+        if (s.type == StreamFrameType::Raw)
+            std::swap(target, s.frame);
+        else
+            apply_delta(s, target);
+        if (&s != due) ++stats_.frames_skipped;
+        s.state = SlotState::Free;
+    }
+
+    // Everything older than the frame shown now is too late
+    for (Slot &slot : slots_)
+        if (slot.state != SlotState::Free && seq_after(seq, slot.seq)) drop(slot);
+
+    presented_seq_ = seq;
+    presented_any_ = true;
+
+    ++stats_.frames_presented;
+    stats_.last_sequence = seq;
+    stats_.latency_us = (uint32_t)(now_us - first_arrival_us);
+    if (stats_.latency_us > stats_.latency_max_us) stats_.latency_max_us = stats_.latency_us;
+    stats_.jitter_us = (uint32_t)jitter_est_us_;
+    publish();
+    return true;
+}
+
+void StreamAnim::init(Frame &target) {
+    target.clear();
+    if (rx_.is_open()) {
+        rx_.reset();
+        return;
+    }
+    const esp_err_t err = rx_.open(port_);
+    if (err != ESP_OK) printf("stream %s: cannot listen on UDP port %u: err=0x%x\n", name_, port_, (unsigned)err);
+}
+
+void StreamAnim::step(Frame &target, uint32_t /*dt_ms*/) {
+    rx_.poll();
+    rx_.present(target, esp_timer_get_time());
+}
+
+} // namespace stream
@@ -0,0 +1,77 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+namespace utils {
+
+// Fast pseudo-random generator for animations (xoshiro128**). Only 32-bit operations, so it
+// costs a handful of cycles on every ESP32 core and never waits on the hardware RNG. Each
+// animation owns one and seeds it once, from rng_seed(), in init().
+class Rng {
+  public:
+    Rng() { seed(0); }
+    explicit Rng(uint64_t s) { seed(s); }
+
+    // Any seed is fine, 0 included: it is spread over the 128-bit state with splitmix64
+    void seed(uint64_t s) {
+        for (int i = 0; i < 4; i += 2) {
+            s += 0x9E3779B97F4A7C15ull;
+            uint64_t z = s;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            z ^= z >> 31;
+            s_[i] = static_cast<uint32_t>(z);
+            s_[i + 1] = static_cast<uint32_t>(z >> 32);
+        }
+    }
+
+    uint32_t next() {
+        const uint32_t result = rotl(s_[1] * 5, 7) * 9;
+        const uint32_t t = s_[1] << 9;
+        s_[2] ^= s_[0];
+        s_[3] ^= s_[1];
+        s_[1] ^= s_[2];
+        s_[0] ^= s_[3];
+        s_[2] ^= t;
+        s_[3] = rotl(s_[3], 11);
+        return result;
+    }
+
+    // Uniform in [0, bound) without modulo bias (Lemire's multiply-shift); bound > 0
+    uint32_t below(uint32_t bound) {
+        uint64_t m = (uint64_t)next() * bound;
+        if (static_cast<uint32_t>(m) < bound) {
+            const uint32_t threshold = (0u - bound) % bound;
+            while (static_cast<uint32_t>(m) < threshold)
+                m = (uint64_t)next() * bound;
+        }
+        return static_cast<uint32_t>(m >> 32);
+    }
+    // Uniform in [lo, hi], inclusive
+    int32_t range(int32_t lo, int32_t hi) {
+        return lo + static_cast<int32_t>(below(static_cast<uint32_t>(hi - lo) + 1));
+    }
+    // Uniform in [0, 1)
+    float unit() { return static_cast<float>(next() >> 8) * (1.0f / 16777216.0f); }
+    // True with probability num / den
+    bool chance(uint32_t num, uint32_t den) { return below(den) < num; }
+
+    // Batch fill, for effects that need many values per frame
+    void fill(uint32_t *out, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            out[i] = next();
+    }
+    void fill_bytes(void *out, size_t len);
+
+  private:
+    static uint32_t rotl(uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+    uint32_t s_[4];
+};
+
+// Seed for a new generator: fresh hardware entropy from esp_random(), or, in deterministic
+// mode, the next value of a fixed sequence so every run renders the same frames.
+uint64_t rng_seed();
+// Switch seeding to the fixed sequence starting at `base` (simulator, benchmarks)
+void rng_set_deterministic(uint64_t base);
+
+} // namespace utils
@@ -0,0 +1,63 @@
+#pragma once
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+namespace utils {
+
+// Tries a reader makes before giving up on a value that keeps changing under it
+#define K_SEQLOCK_READ_TRIES 4
+
+// Single-writer sequence lock: shares a small value between tasks without ever blocking the
+// writer. The sequence number is odd while a write is in progress; a reader copies the value
+// and keeps the copy only if the number was even and unchanged around it. The value is held
+// as relaxed atomic words, so an overlapping read is detected rather than being a data race.
+// Readers never wait for the writer, so a reader that can preempt the writer (higher
+// priority on the same core) may give up after K_SEQLOCK_READ_TRIES; run the writer above
+// its readers and reads always succeed at the first or second try.
+template <typename T> class Seqlock {
+    static_assert(std::is_trivially_copyable_v<T> && sizeof(T) % 4 == 0, "copied as 32-bit words");
+
+  public:
+    // Only one task may write
+    void write(const T &value) {
+        uint32_t w[WORDS];
+        memcpy(w, &value, sizeof(T));
+        const uint32_t s = seq_.load(std::memory_order_relaxed);
+        seq_.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; ++i)
+            words_[i].store(w[i], std::memory_order_relaxed);
+        seq_.store(s + 2, std::memory_order_release);
+    }
+
+    // Copy the newest value into `out`. Returns false, leaving `out` untouched, if a write
+    // overlapped every try. Before the first write the value reads as all zero bytes.
+    bool read(T &out, int tries = K_SEQLOCK_READ_TRIES) const {
+        uint32_t w[WORDS];
+        while (tries-- > 0) {
+            const uint32_t s = seq_.load(std::memory_order_acquire);
+            if (s & 1) continue;
+            for (size_t i = 0; i < WORDS; ++i)
+                w[i] = words_[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) != s) continue;
+            memcpy(&out, w, sizeof(T));
+            return true;
+        }
+        return false;
+    }
+
+    // Completed writes so far; a reader can compare it with an earlier value to skip
+    // unchanged data
+    uint32_t version() const { return seq_.load(std::memory_order_acquire) / 2; }
+
+  private:
+    static constexpr size_t WORDS = sizeof(T) / 4;
+    std::atomic<uint32_t> seq_{0};
+    std::atomic<uint32_t> words_[WORDS] = {};
+};
+
+} // namespace utils
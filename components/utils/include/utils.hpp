@@ -1,4 +1,5 @@
 #pragma once
+#include "rng.hpp"
 #include <stdint.h>
 
 namespace utils {
@@ -9,6 +10,23 @@ typedef struct {
     uint8_t b;
 } rgb_t;
 
-rgb_t random_color(void);
+// Avoids too-dim colours: each channel in [32, 255]
+rgb_t random_color(Rng &rng);
+
+// Scale an 8-bit value by s/255 without floating point (exact at s = 0 and s = 255)
+inline uint8_t scale8(uint8_t v, uint8_t s) { return static_cast<uint8_t>((v * (static_cast<uint16_t>(s) + 1)) >> 8); }
+
+inline rgb_t scale(rgb_t c, uint8_t s) { return rgb_t{scale8(c.r, s), scale8(c.g, s), scale8(c.b, s)}; }
+
+// Fully saturated colour at `pos` on a 256-step wheel: red at 0, green at 85, blue at 170
+inline rgb_t color_wheel(uint8_t pos) {
+    if (pos < 85) return rgb_t{static_cast<uint8_t>(255 - pos * 3), static_cast<uint8_t>(pos * 3), 0};
+    if (pos < 170) {
+        pos = static_cast<uint8_t>(pos - 85);
+        return rgb_t{0, static_cast<uint8_t>(255 - pos * 3), static_cast<uint8_t>(pos * 3)};
+    }
+    pos = static_cast<uint8_t>(pos - 170); // 0..85, so 255 is back at red
+    return rgb_t{static_cast<uint8_t>(pos * 3), 0, static_cast<uint8_t>(255 - pos * 3)};
+}
 
 } // namespace utils
@@ -0,0 +1,33 @@
+#include "include/rng.hpp"
+#include "esp_random.h"
+#include <atomic>
+#include <string.h>
+
+namespace utils {
+
+static std::atomic<bool> s_deterministic{false};
+static std::atomic<uint64_t> s_next_seed{0};
+
+void Rng::fill_bytes(void *out, size_t len) {
+    uint8_t *p = static_cast<uint8_t *>(out);
+    for (; len >= 4; len -= 4, p += 4) {
+        const uint32_t r = next();
+        memcpy(p, &r, 4);
+    }
+    if (len) {
+        const uint32_t r = next();
+        memcpy(p, &r, len);
+    }
+}
+
+uint64_t rng_seed() {
+    if (s_deterministic.load(std::memory_order_relaxed)) return s_next_seed.fetch_add(1, std::memory_order_relaxed);
+    return (uint64_t)esp_random() << 32 | esp_random();
+}
+
+void rng_set_deterministic(uint64_t base) {
+    s_next_seed.store(base, std::memory_order_relaxed);
+    s_deterministic.store(true, std::memory_order_relaxed);
+}
+
+} // namespace utils
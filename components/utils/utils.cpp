@@ -1,14 +1,16 @@
 
 #include "include/utils.hpp"
-#include "esp_random.h"
 
 namespace utils {
 
-// Avoid too-dim colors: pick each channel in [32, 255]
-rgb_t random_color(void) {
-    uint8_t r = (esp_random() % 224) + 32;
-    uint8_t g = (esp_random() % 224) + 32;
-    uint8_t b = (esp_random() % 224) + 32;
+rgb_t random_color(Rng &rng) {
+    // One draw covers all three channels: 224^3 < 2^32
+    uint32_t v = rng.below(224u * 224u * 224u);
+    const uint8_t r = static_cast<uint8_t>(v % 224 + 32);
+    v /= 224;
+    const uint8_t g = static_cast<uint8_t>(v % 224 + 32);
+    v /= 224;
+    const uint8_t b = static_cast<uint8_t>(v + 32);
     return rgb_t{r, g, b};
 }
 
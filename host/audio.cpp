@@ -0,0 +1,88 @@
+// Host audio check: analyses a WAV file hop by hop as the audio task would, interleaved with
+// the audio animations' frames on the simulated clock, and prints the beats it found, what the
+// analysis costs per hop and a digest of each animation's frames.
+// Usage: aurorabox_audio <in.wav> [frames]
+#include "audio_anim.hpp"
+#include "esp_timer.h"
+#include "wav_source.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace audio_animation;
+
+static uint32_t digest(uint32_t h, const Frame &f) {
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(f.data());
+    for (size_t i = 0; i < f.bytes(); ++i) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <in.wav> [frames]\n", argv[0]);
+        return 2;
+    }
+    const uint32_t max_frames = argc > 2 ? static_cast<uint32_t>(strtoul(argv[2], nullptr, 10)) : UINT32_MAX;
+    utils::rng_set_deterministic(1);
+
+    WavSource wav;
+    if (!wav.open(argv[1])) return 1;
+    static audio::Analyzer analyzer(wav.sample_rate());
+    static Feed feed;
+
+    static SpectrumAnim spectrum(feed);
+    static BeatBurstAnim beat_burst(feed);
+    IAnimation *const animations[] = {&spectrum, &beat_burst};
+    Frame frames[2] = {Frame(K_PANEL_WIDTH, K_PANEL_HEIGHT, 8), Frame(K_PANEL_WIDTH, K_PANEL_HEIGHT, 8)};
+    uint32_t digests[2] = {2166136261u, 2166136261u};
+    for (int i = 0; i < 2; ++i)
+        animations[i]->init(frames[i]);
+
+    // Audio time, from the samples consumed so far, drives both the analysis and the frames
+    int16_t hop[K_AUDIO_HOP];
+    uint64_t samples = 0;
+    uint32_t hops = 0, beats = 0, frame_count = 0;
+    int64_t analysis_us = 0, worst_us = 0;
+    bool done = false;
+    for (; frame_count < max_frames && !done; ++frame_count) {
+        const uint64_t frame_end_us = (uint64_t)(frame_count + 1) * K_AUDIO_ANIM_FRAME_MS * 1000;
+        while (samples * 1000000 / wav.sample_rate() < frame_end_us) {
+            const size_t n = wav.read(hop, K_AUDIO_HOP);
+            if (n < K_AUDIO_HOP) {
+                done = true;
+                break;
+            }
+            samples += n;
+            const int64_t t0 = esp_timer_get_time();
+            const audio::Features &f = analyzer.process(hop, (int64_t)(samples * 1000000 / wav.sample_rate()));
+            const int64_t cost = esp_timer_get_time() - t0;
+            analysis_us += cost;
+            if (cost > worst_us) worst_us = cost;
+            feed.write(f);
+            ++hops;
+            if (f.beats != beats) {
+                beats = f.beats;
+                printf("beat %3lu at %7.3f s  strength=%3u level=%3u\n", (unsigned long)beats, f.time_us / 1e6,
+                       f.beat_strength, f.level);
+            }
+        }
+        for (int i = 0; i < 2; ++i) {
+            animations[i]->step(frames[i], frame_count ? K_AUDIO_ANIM_FRAME_MS : 0);
+            digests[i] = digest(digests[i], frames[i]);
+        }
+    }
+
+    const audio::Features &f = analyzer.features();
+    printf("%lu hops (%.1f s), %lu beats, analysis %.1f us/hop (worst %lld us), last level=%u bands:",
+           (unsigned long)hops, samples / (double)wav.sample_rate(), (unsigned long)beats,
+           hops ? (double)analysis_us / hops : 0.0, (long long)worst_us, f.level);
+    for (uint8_t b : f.bands)
+        printf(" %u", b);
+    printf("\n");
+    for (int i = 0; i < 2; ++i)
+        printf("%-12s frames=%lu digest=%08lx\n", animations[i]->name(), (unsigned long)frame_count,
+               (unsigned long)digests[i]);
+    return 0;
+}
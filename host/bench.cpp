@@ -0,0 +1,122 @@
+// Host benchmark: every animation on a Backend::Sim cube with the firmware's chain layout.
+// Usage: aurorabox_bench [frames] [N], N > 0 also benchmarks an N x N x N cube
+#include "bench.hpp"
+#include "esp_cpu.h"
+#include "esp_timer.h"
+#include "static_cube.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace cube;
+
+using StaticFirmwareCube = StaticCube<K_PANEL_WIDTH, K_PANEL_HEIGHT, PanelChainConfig{5, 4, false},
+                                      PanelChainConfig{14, 4, false}>;
+
+// Synthetic fade + scattered writes + show(), to compare the run-time and compile-time cube cores
+static bench::BenchResult run_core(const char *name, Cube &c, uint32_t frames) {
+    bench::BenchResult r;
+    r.name = name;
+    r.frames = frames;
+    r.budget_ms = K_DEFAULT_FRAME_MS;
+    const uint64_t bytes_before = c.bytes_sent();
+    utils::Rng rng(1);
+    for (uint32_t f = 0; f < frames; ++f) {
+        const int64_t t0 = esp_timer_get_time();
+        const uint32_t c0 = esp_cpu_get_cycle_count();
+        c.fade(200);
+        for (uint32_t i = 0; i < 64; ++i) {
+            const uint32_t r32 = rng.next();
+            c((r32 >> 0) % c.width(), (r32 >> 8) % c.height(), (r32 >> 16) % c.depth()) = rgb_t{255, 128, 32};
+        }
+        ESP_ERROR_CHECK(c.show());
+        r.cycles += static_cast<uint32_t>(esp_cpu_get_cycle_count() - c0);
+        const uint32_t us = static_cast<uint32_t>(esp_timer_get_time() - t0);
+        r.elapsed_us += us;
+        if (us > r.worst_us) r.worst_us = us;
+    }
+    r.bytes = c.bytes_sent() - bytes_before;
+    return r;
+}
+
+// The cube core on StaticCube `S` and on a run-time Cube with the same layout
+template <class S> static void run_core_pair(const char *rt_name, const char *static_name, uint32_t frames) {
+    CubeCreateArgs args{.backend = Backend::Sim,
+                        .chains = S::kChains.data(),
+                        .chain_count = S::kChainCount,
+                        .panels_width = S::kWidth,
+                        .panels_height = S::kHeight};
+    Cube rt(args);
+    S st(Backend::Sim);
+    Cube *const cubes[] = {&rt, &st};
+    for (Cube *c : cubes) {
+        c->set_global_brightness(0.3f);
+        for (size_t ci = 0; ci < c->chain_count(); ++ci)
+            c->sim_strip(ci)->record = false;
+    }
+    bench::print_result(run_core(rt_name, rt, frames));
+    bench::print_result(run_core(static_name, st, frames));
+}
+
+// Larger N x N x N cube with its faces spread over `chain_count` chains
+static void run_scaled(uint32_t n, size_t chain_count, uint32_t frames) {
+    static const int pins[K_MAX_SIM_CHAINS] = {0, 1, 2, 3, 4, 5, 6, 7};
+    PanelChainConfig chains[K_MAX_SIM_CHAINS];
+    const size_t count = spread_faces(n, pins, chain_count, false, chains);
+    CubeCreateArgs args{
+        .backend = Backend::Sim, .chains = chains, .chain_count = count, .panels_width = n, .panels_height = n};
+    Cube cube(args);
+    for (size_t ci = 0; ci < cube.chain_count(); ++ci)
+        cube.sim_strip(ci)->record = false;
+    printf("\n%lux%lux%lu on %u chains: wire time %lu us (max %lu fps)\n", (unsigned long)n, (unsigned long)n,
+           (unsigned long)n, (unsigned)count, (unsigned long)cube.wire_time_us(),
+           (unsigned long)(1000000 / cube.wire_time_us()));
+    bench::run_all(cube, frames);
+}
+
+int main(int argc, char **argv) {
+    const uint32_t frames = argc > 1 ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 10)) : K_BENCH_DEFAULT_FRAMES;
+    const uint32_t scaled = argc > 2 ? static_cast<uint32_t>(strtoul(argv[2], nullptr, 10)) : 0;
+    utils::rng_set_deterministic(1);
+
+    PanelChainConfig chains[] = {
+        {.pin = 5, .panels = 4, .first_row_backwards = false},
+        {.pin = 14, .panels = 4, .first_row_backwards = false},
+    };
+
+    CubeCreateArgs args{.backend = Backend::Sim,
+                        .chains = chains,
+                        .chain_count = 2,
+                        .panels_width = K_PANEL_WIDTH,
+                        .panels_height = K_PANEL_HEIGHT};
+    Cube cube(args);
+    cube.set_global_brightness(0.3f);
+    // Only the counters matter here
+    for (size_t ci = 0; ci < cube.chain_count(); ++ci)
+        cube.sim_strip(ci)->record = false;
+
+    printf("8x8x8 on 2 chains: wire time %lu us (max %lu fps)\n", (unsigned long)cube.wire_time_us(),
+           (unsigned long)(1000000 / cube.wire_time_us()));
+    bench::run_all(cube, frames);
+
+    // The same suite on the compile-time cube, which animations drive through the same Cube API
+    static StaticFirmwareCube static_cube(Backend::Sim);
+    static_cube.set_global_brightness(0.3f);
+    for (size_t ci = 0; ci < StaticFirmwareCube::kChainCount; ++ci)
+        static_cube.sim_strip(ci)->record = false;
+    printf("\n8x8x8 StaticCube on 2 chains\n");
+    bench::run_all(static_cube, frames);
+
+    // Cube core only: the same workload on run-time and compile-time cubes of three sizes
+    bench::print_header();
+    run_core_pair<StaticFirmwareCube>("rt_n8", "static_n8", frames);
+    run_core_pair<StaticCube<4, 4, PanelChainConfig{5, 4, false}>>("rt_n4", "static_n4", frames);
+    run_core_pair<StaticCube<16, 16, PanelChainConfig{5, 8, false}, PanelChainConfig{14, 8, false}>>(
+        "rt_n16", "static_n16", frames);
+
+    // Optional: the same suite on a scaled-up N x N x N cube, with 2 and with 8 parallel chains
+    if (scaled) {
+        run_scaled(scaled, 2, frames);
+        run_scaled(scaled, K_MAX_SIM_CHAINS, frames);
+    }
+    return 0;
+}
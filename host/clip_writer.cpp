@@ -0,0 +1,207 @@
+#include "clip_writer.hpp"
+#include <algorithm>
+#include <unordered_map>
+
+namespace clip {
+
+static inline uint32_t pack(rgb_t c) { return (uint32_t)c.r << 16 | (uint32_t)c.g << 8 | c.b; }
+
+static inline uint32_t dist2(uint32_t a, uint32_t b) {
+    const int32_t dr = (int32_t)(a >> 16 & 0xFF) - (int32_t)(b >> 16 & 0xFF);
+    const int32_t dg = (int32_t)(a >> 8 & 0xFF) - (int32_t)(b >> 8 & 0xFF);
+    const int32_t db = (int32_t)(a & 0xFF) - (int32_t)(b & 0xFF);
+    return (uint32_t)(dr * dr + dg * dg + db * db);
+}
+
+static inline uint32_t channel_error(uint32_t a, uint32_t b) {
+    uint32_t worst = 0;
+    for (int shift = 0; shift < 24; shift += 8) {
+        const int32_t d = (int32_t)(a >> shift & 0xFF) - (int32_t)(b >> shift & 0xFF);
+        const uint32_t e = (uint32_t)(d < 0 ? -d : d);
+        if (e > worst) worst = e;
+    }
+    return worst;
+}
+
+// Palette for a set of (colour, use count) pairs: the exact colours when they fit, otherwise
+// median cut, repeatedly halving the box with the widest channel range at its weighted median
+static std::vector<uint32_t> median_cut(std::vector<std::pair<uint32_t, uint32_t>> colours) {
+    std::vector<uint32_t> palette;
+    if (colours.size() <= K_CLIP_MAX_PALETTE) {
+        for (const auto &e : colours)
+            palette.push_back(e.first);
+        return palette;
+    }
+
+    struct Box {
+        size_t begin, end; // range of `colours`
+        int shift;         // channel with the widest range (16, 8 or 0)
+        uint32_t range;
+    };
+    auto measure = [&](size_t begin, size_t end) {
+        Box b{begin, end, 0, 0};
+        for (int shift = 0; shift < 24; shift += 8) {
+            uint32_t lo = 255, hi = 0;
+            for (size_t i = begin; i < end; ++i) {
+                const uint32_t v = colours[i].first >> shift & 0xFF;
+                lo = std::min(lo, v);
+                hi = std::max(hi, v);
+            }
+            if (hi - lo >= b.range) {
+                b.range = hi - lo;
+                b.shift = shift;
+            }
+        }
+        return b;
+    };
+
+    std::vector<Box> boxes{measure(0, colours.size())};
+    while (boxes.size() < K_CLIP_MAX_PALETTE) {
+        auto widest = std::max_element(boxes.begin(), boxes.end(), [](const Box &a, const Box &b) {
+            return (a.end - a.begin > 1 ? a.range : 0) < (b.end - b.begin > 1 ? b.range : 0);
+        });
+        if (widest->end - widest->begin < 2 || widest->range == 0) break;
+        const Box b = *widest;
+        std::sort(colours.begin() + b.begin, colours.begin() + b.end, [&](const auto &x, const auto &y) {
+            return (x.first >> b.shift & 0xFF) < (y.first >> b.shift & 0xFF);
+        });
+        uint64_t total = 0, acc = 0;
+        for (size_t i = b.begin; i < b.end; ++i)
+            total += colours[i].second;
+        size_t mid = b.begin + 1;
+        for (size_t i = b.begin; i + 1 < b.end; ++i) {
+            acc += colours[i].second;
+            mid = i + 1;
+            if (2 * acc >= total) break;
+        }
+        *widest = measure(b.begin, mid);
+        boxes.push_back(measure(mid, b.end));
+    }
+
+    // Each box contributes its use-weighted mean colour
+    for (const Box &b : boxes) {
+        uint64_t sum[3] = {0, 0, 0}, n = 0;
+        for (size_t i = b.begin; i < b.end; ++i) {
+            for (int k = 0; k < 3; ++k)
+                sum[k] += (uint64_t)(colours[i].first >> (16 - 8 * k) & 0xFF) * colours[i].second;
+            n += colours[i].second;
+        }
+        palette.push_back((uint32_t)((sum[0] + n / 2) / n) << 16 | (uint32_t)((sum[1] + n / 2) / n) << 8 |
+                          (uint32_t)((sum[2] + n / 2) / n));
+    }
+    return palette;
+}
+
+static void put16(std::vector<uint8_t> &out, uint16_t v) {
+    out.push_back((uint8_t)v);
+    out.push_back((uint8_t)(v >> 8));
+}
+
+static void put32(std::vector<uint8_t> &out, uint32_t v) {
+    put16(out, (uint16_t)v);
+    put16(out, (uint16_t)(v >> 16));
+}
+
+static inline uint8_t op_byte(Op op, size_t count) { return (uint8_t)((uint8_t)op << 6 | (count - 1)); }
+
+// Ops for one frame of palette indices; `prev` is null for key frames
+static void encode_frame(std::vector<uint8_t> &out, const uint8_t *idx, const uint8_t *prev, size_t n) {
+    auto same_run = [&](size_t v) {
+        size_t r = 1;
+        while (v + r < n && r < K_CLIP_MAX_RUN && idx[v + r] == idx[v])
+            ++r;
+        return r;
+    };
+    auto skip_run = [&](size_t v) {
+        size_t r = 0;
+        while (prev && v + r < n && r < K_CLIP_MAX_RUN && idx[v + r] == prev[v + r])
+            ++r;
+        return r;
+    };
+
+    size_t v = 0;
+    while (v < n) {
+        if (const size_t s = skip_run(v)) {
+            out.push_back(op_byte(Op::Skip, s));
+            v += s;
+            continue;
+        }
+        const size_t r = same_run(v);
+        if (r >= 3) {
+            out.push_back(op_byte(Op::Repeat, r));
+            out.push_back(idx[v]);
+            v += r;
+            continue;
+        }
+        // Literal up to the next run worth its own op
+        size_t end = v + 1;
+        while (end < n && end - v < K_CLIP_MAX_RUN && skip_run(end) < 2 && same_run(end) < 3)
+            ++end;
+        out.push_back(op_byte(Op::Literal, end - v));
+        out.insert(out.end(), idx + v, idx + end);
+        v = end;
+    }
+}
+
+void ClipWriter::add(const Frame &frame) {
+    frames_.insert(frames_.end(), frame.data(), frame.data() + voxels());
+}
+
+std::vector<uint8_t> ClipWriter::encode(uint32_t *max_error) const {
+    const size_t n = voxels();
+    const size_t count = frame_count();
+
+    std::unordered_map<uint32_t, uint32_t> uses;
+    for (const rgb_t &c : frames_)
+        ++uses[pack(c)];
+    std::vector<std::pair<uint32_t, uint32_t>> colours(uses.begin(), uses.end());
+    std::sort(colours.begin(), colours.end());
+    if (colours.empty()) colours.emplace_back(0, 1);
+    const std::vector<uint32_t> palette = median_cut(colours);
+    const size_t palette_size = palette.size();
+
+    std::unordered_map<uint32_t, uint8_t> index;
+    uint32_t worst = 0;
+    for (const auto &e : colours) {
+        size_t best = 0;
+        for (size_t p = 1; p < palette_size; ++p)
+            if (dist2(e.first, palette[p]) < dist2(e.first, palette[best])) best = p;
+        index.emplace(e.first, (uint8_t)best);
+        worst = std::max(worst, channel_error(e.first, palette[best]));
+    }
+    if (max_error) *max_error = worst;
+
+    std::vector<uint8_t> out(K_CLIP_MAGIC, K_CLIP_MAGIC + 4);
+    out.push_back(K_CLIP_VERSION);
+    out.push_back((uint8_t)width_);
+    out.push_back((uint8_t)height_);
+    out.push_back((uint8_t)depth_);
+    put32(out, (uint32_t)count);
+    put16(out, frame_ms_);
+    put16(out, (uint16_t)palette_size);
+    for (uint32_t c : palette) {
+        out.push_back((uint8_t)(c >> 16));
+        out.push_back((uint8_t)(c >> 8));
+        out.push_back((uint8_t)c);
+    }
+
+    std::vector<uint8_t> cur(n), prev(n);
+    for (size_t f = 0; f < count; ++f) {
+        const rgb_t *src = frames_.data() + f * n;
+        for (size_t v = 0; v < n; ++v)
+            cur[v] = index.at(pack(src[v]));
+
+        const bool key = key_interval_ == 0 ? f == 0 : f % key_interval_ == 0;
+        const size_t header = out.size();
+        out.push_back((uint8_t)(key ? FrameType::Key : FrameType::Delta));
+        put32(out, 0);
+        encode_frame(out, cur.data(), key ? nullptr : prev.data(), n);
+        const uint32_t len = (uint32_t)(out.size() - header - K_CLIP_FRAME_HEADER_BYTES);
+        for (int i = 0; i < 4; ++i)
+            out[header + 1 + i] = (uint8_t)(len >> (8 * i));
+        cur.swap(prev);
+    }
+    return out;
+}
+
+} // namespace clip
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "clip.hpp"
+#include <stdint.h>
+#include <vector>
+
+// Host-side encoder for the clip format described in clip.hpp.
+namespace clip {
+
+class ClipWriter {
+  public:
+    // `key_interval` frames apart at most (frame 0 is always a key frame)
+    ClipWriter(uint32_t width, uint32_t height, uint32_t depth, uint16_t frame_ms, uint32_t key_interval = 64)
+        : width_(width), height_(height), depth_(depth), frame_ms_(frame_ms), key_interval_(key_interval) {}
+
+    void add(const Frame &frame);
+    uint32_t frame_count() const { return (uint32_t)frames_.size() / voxels(); }
+
+    // Build the palette and encode every added frame. If the frames use more colours than
+    // the palette holds, it is reduced by median cut and each colour is replaced by its
+    // nearest entry; `max_error` reports the largest per-channel difference that caused.
+    std::vector<uint8_t> encode(uint32_t *max_error = nullptr) const;
+
+  private:
+    uint32_t voxels() const { return width_ * height_ * depth_; }
+
+    uint32_t width_, height_, depth_;
+    uint16_t frame_ms_;
+    uint32_t key_interval_;
+    std::vector<rgb_t> frames_; // all frames back to back
+};
+
+} // namespace clip
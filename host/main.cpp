@@ -0,0 +1,102 @@
+// Host simulator: runs every animation against a Backend::Sim cube with the same
+// chain layout as main/main.cpp and prints a digest of the frames each one produced.
+#include "circle.hpp"
+#include "compositor.hpp"
+#include "countdown.hpp"
+#include "cube.hpp"
+#include "noise_anim.hpp"
+#include "rain.hpp"
+#include "scroll_text.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace cube;
+using namespace rain_animation;
+using namespace countdown_animation;
+using namespace circle_animation;
+using namespace scroll_text_animation;
+using namespace noise_animation;
+
+// FNV-1a over every frame the strip recorded
+static uint32_t digest(const SimStrip &s) {
+    uint32_t h = 2166136261u;
+    for (uint8_t b : s.frames) {
+        h ^= b;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+int main(int argc, char **argv) {
+    const uint32_t frames = argc > 1 ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 10)) : 200;
+    utils::rng_set_deterministic(1);
+
+    PanelChainConfig chains[] = {
+        {.pin = 5, .panels = 4, .first_row_backwards = false},
+        {.pin = 14, .panels = 4, .first_row_backwards = false},
+    };
+
+    CubeCreateArgs args{.backend = Backend::Sim,
+                        .chains = chains,
+                        .chain_count = 2,
+                        .panels_width = K_PANEL_WIDTH,
+                        .panels_height = K_PANEL_HEIGHT};
+    Cube cube(args);
+    cube.set_global_brightness(0.3f);
+
+    static LightRainAnim light_rain;
+    static HeavyRainAnim heavy_rain;
+    static CountdownAnim countdown;
+    static CircleSpinAnim circle_spin;
+    static ScrollTextAnim scroll_text;
+    static PlasmaAnim plasma;
+    static FireAnim fire;
+    static CloudsAnim clouds;
+    static CircleSpinAnim disc_layer;
+    static LightRainAnim rain_layer;
+    const compositor::Layer rain_disc_layers[] = {
+        {&disc_layer, BlendMode::Alpha, 255},
+        {&rain_layer, BlendMode::Add, 255},
+    };
+    static compositor::Compositor rain_disc("rain_disc", rain_disc_layers, 2);
+
+    struct Entry {
+        const char *name;
+        IAnimation *anim;
+    };
+    const Entry animations[] = {
+        {"light_rain", &light_rain},
+        {"heavy_rain", &heavy_rain},
+        {"countdown", &countdown},
+        {"circle_spin", &circle_spin},
+        {"scroll_text", &scroll_text},
+        {"rain_disc", &rain_disc},
+        {"plasma", &plasma},
+        {"fire", &fire},
+        {"clouds", &clouds},
+    };
+
+    for (const Entry &e : animations) {
+        for (size_t ci = 0; ci < cube.chain_count(); ++ci) {
+            cube.sim_strip(ci)->clear_recording();
+            cube.sim_strip(ci)->record_limit = frames + 1;
+        }
+
+        e.anim->init(cube.frame());
+        for (uint32_t f = 0; f < frames; ++f) {
+            e.anim->step(cube.frame(), e.anim->frame_period_ms());
+            ESP_ERROR_CHECK(cube.show());
+            e.anim->prefetch();
+        }
+        ESP_ERROR_CHECK(cube.wait_idle());
+
+        printf("%-12s frames=%lu", e.name, (unsigned long)frames);
+        for (size_t ci = 0; ci < cube.chain_count(); ++ci) {
+            const SimStrip &s = *cube.sim_strip(ci);
+            printf("  chain%u: recorded=%zu digest=%08lx", (unsigned)ci, s.recorded_frames(),
+                   (unsigned long)digest(s));
+        }
+        printf("\n");
+    }
+    return 0;
+}
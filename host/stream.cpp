@@ -0,0 +1,137 @@
+// Host stream check: renders an animation, sends it with StreamSender over UDP on the loopback
+// interface with simulated loss and delay, receives it with a StreamReceiver polled the way
+// StreamAnim polls it, and checks every presented frame against the frame sent with that
+// sequence number.
+// Usage: aurorabox_stream <animation> <frames> [loss %] [max delay ms] [port]
+#include "circle.hpp"
+#include "countdown.hpp"
+#include "esp_timer.h"
+#include "rain.hpp"
+#include "scroll_text.hpp"
+#include "stream_sender.hpp"
+#include <arpa/inet.h>
+#include <map>
+#include <netinet/in.h>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace rain_animation;
+using namespace countdown_animation;
+using namespace circle_animation;
+using namespace scroll_text_animation;
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s <animation> <frames> [loss %%] [max delay ms] [port]\n", argv[0]);
+        return 2;
+    }
+    const uint32_t frames = static_cast<uint32_t>(strtoul(argv[2], nullptr, 10));
+    const double loss = argc > 3 ? strtod(argv[3], nullptr) / 100.0 : 0.0;
+    const uint32_t max_delay_us = argc > 4 ? static_cast<uint32_t>(strtoul(argv[4], nullptr, 10)) * 1000 : 0;
+    const uint16_t port = argc > 5 ? static_cast<uint16_t>(strtoul(argv[5], nullptr, 10)) : K_STREAM_DEFAULT_PORT;
+    utils::rng_set_deterministic(1);
+
+    static LightRainAnim light_rain;
+    static HeavyRainAnim heavy_rain;
+    static CountdownAnim countdown;
+    static CircleSpinAnim circle_spin;
+    static ScrollTextAnim scroll_text;
+    IAnimation *const animations[] = {&light_rain, &heavy_rain, &countdown, &circle_spin, &scroll_text};
+    IAnimation *anim = nullptr;
+    for (IAnimation *a : animations)
+        if (strcmp(a->name(), argv[1]) == 0) anim = a;
+    if (!anim || frames == 0) {
+        fprintf(stderr, "unknown animation '%s' or no frames\n", argv[1]);
+        return 2;
+    }
+
+    const uint32_t w = K_PANEL_WIDTH, h = K_PANEL_HEIGHT, d = 8;
+    stream::StreamReceiver rx(w, h, d);
+    if (rx.open(port) != ESP_OK) {
+        fprintf(stderr, "cannot listen on UDP port %u\n", port);
+        return 1;
+    }
+    const int tx = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    sockaddr_in to = {};
+    to.sin_family = AF_INET;
+    to.sin_port = htons(port);
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    stream::StreamSender sender(w, h, d);
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    // Datagrams waiting out their simulated delay, by send time; equal delays keep their order
+    std::multimap<int64_t, std::vector<uint8_t>> in_flight;
+    // Frames sent and not yet presented or passed over, by sequence number
+    std::map<uint32_t, Frame> sent;
+
+    Frame render(w, h, d), shown(w, h, d);
+    anim->init(render);
+    uint32_t rendered = 0, datagrams = 0, dropped = 0, raw = 0, mismatches = 0;
+    const int64_t start = esp_timer_get_time();
+    int64_t next_frame = start, next_poll = start, last_send = start;
+    while (true) {
+        const int64_t now = esp_timer_get_time();
+        if (rendered < frames && now >= next_frame) {
+            anim->step(render, rendered ? anim->frame_period_ms() : 0);
+            const uint32_t seq = sender.sequence();
+            const auto out = sender.encode(render, (uint32_t)(next_frame - start));
+            if (out[0][5] == (uint8_t)stream::StreamFrameType::Raw) ++raw;
+            sent.emplace(seq, Frame(w, h, d)).first->second.copy_from(render);
+            for (const auto &dg : out) {
+                ++datagrams;
+                if (uniform(rng) < loss) {
+                    ++dropped;
+                    continue;
+                }
+                in_flight.emplace(now + (int64_t)(uniform(rng) * max_delay_us), dg);
+            }
+            next_frame += anim->frame_period_ms() * 1000;
+            ++rendered;
+        }
+        while (!in_flight.empty() && in_flight.begin()->first <= now) {
+            const std::vector<uint8_t> &dg = in_flight.begin()->second;
+            sendto(tx, dg.data(), dg.size(), 0, reinterpret_cast<const sockaddr *>(&to), sizeof(to));
+            in_flight.erase(in_flight.begin());
+            last_send = now;
+        }
+        if (now >= next_poll) {
+            rx.poll();
+            if (rx.present(shown, esp_timer_get_time())) {
+                stream::StreamStats st;
+                rx.stats(st);
+                auto it = sent.find(st.last_sequence);
+                if (it == sent.end() || memcmp(it->second.data(), shown.data(), shown.bytes()) != 0) {
+                    ++mismatches;
+                    fprintf(stderr, "frame %lu presented wrong\n", (unsigned long)st.last_sequence);
+                }
+                sent.erase(sent.begin(), it == sent.end() ? it : ++it);
+            }
+            next_poll += K_STREAM_POLL_MS * 1000;
+        }
+        // Done once everything sent has had the reassembly and jitter time to come out
+        if (rendered == frames && in_flight.empty() &&
+            now - last_send > K_STREAM_REASSEMBLY_US + 2 * K_STREAM_JITTER_US)
+            break;
+        usleep(500);
+    }
+    const double seconds = (esp_timer_get_time() - start) / 1e6;
+    close(tx);
+
+    stream::StreamStats st;
+    rx.stats(st);
+    printf("sent %lu frames (%lu raw) in %lu datagrams, %lu dropped\n", (unsigned long)rendered,
+           (unsigned long)raw, (unsigned long)datagrams, (unsigned long)dropped);
+    printf("received %lu datagrams, %.1f kB/s, %lu malformed, %lu stale\n", (unsigned long)st.datagrams,
+           st.bytes / 1000.0 / seconds, (unsigned long)st.malformed, (unsigned long)st.stale);
+    printf("presented %lu, skipped %lu, incomplete %lu, undecodable %lu, lost %lu, mismatches %lu\n",
+           (unsigned long)st.frames_presented, (unsigned long)st.frames_skipped, (unsigned long)st.frames_incomplete,
+           (unsigned long)st.frames_undecodable, (unsigned long)st.frames_lost, (unsigned long)mismatches);
+    printf("latency %lu us (max %lu us), jitter %lu us\n", (unsigned long)st.latency_us,
+           (unsigned long)st.latency_max_us, (unsigned long)st.jitter_us);
+    return mismatches || !st.frames_presented ? 1 : 0;
+}
@@ -0,0 +1,84 @@
+#include "stream_sender.hpp"
+#include <string.h>
+
+namespace stream {
+
+static void put32(std::vector<uint8_t> &out, uint32_t v) {
+    for (int i = 0; i < 4; ++i)
+        out.push_back((uint8_t)(v >> (8 * i)));
+}
+
+// Header with the fragment index and count left to fill in once the frame is split
+static std::vector<uint8_t> start_datagram(StreamFrameType type, uint32_t seq, uint32_t pts_us, uint32_t offset) {
+    std::vector<uint8_t> d(K_STREAM_MAGIC, K_STREAM_MAGIC + 4);
+    d.push_back(K_STREAM_VERSION);
+    d.push_back((uint8_t)type);
+    d.push_back(0);
+    d.push_back(0);
+    put32(d, seq);
+    put32(d, pts_us);
+    put32(d, offset);
+    return d;
+}
+
+std::vector<std::vector<uint8_t>> StreamSender::encode(const Frame &frame, uint32_t pts_us) {
+    const uint8_t *cur = reinterpret_cast<const uint8_t *>(frame.data());
+    const uint8_t *prev = reinterpret_cast<const uint8_t *>(prev_.data());
+    const size_t voxels = frame.voxels();
+    const size_t bytes = frame.bytes();
+    const size_t budget = K_STREAM_HEADER_BYTES + K_STREAM_MAX_PAYLOAD;
+    std::vector<std::vector<uint8_t>> out;
+
+    bool key = seq_ == 0 || (key_interval_ && seq_ % key_interval_ == 0);
+    if (!key) {
+        auto changed = [&](size_t v) { return memcmp(cur + v * 3, prev + v * 3, 3) != 0; };
+        size_t delta_bytes = 0;
+        size_t pos = 0; // voxel after the last span of the current datagram
+        out.push_back(start_datagram(StreamFrameType::Delta, seq_, pts_us, 0));
+        for (size_t v = 0; v < voxels; ++v) {
+            if (!changed(v)) continue;
+            // A new datagram when this one is full or the gap does not fit a span's u16
+            if (out.back().size() + 6 > budget || v - pos > 0xFFFF) {
+                delta_bytes += out.back().size();
+                out.push_back(start_datagram(StreamFrameType::Delta, seq_, pts_us, (uint32_t)v));
+                pos = v;
+            }
+            std::vector<uint8_t> &d = out.back();
+            const size_t room = (budget - d.size() - 3) / 3;
+            size_t count = 1;
+            while (count < 255 && count < room && v + count < voxels && changed(v + count))
+                ++count;
+            d.push_back((uint8_t)(v - pos));
+            d.push_back((uint8_t)((v - pos) >> 8));
+            d.push_back((uint8_t)count);
+            d.insert(d.end(), cur + v * 3, cur + (v + count) * 3);
+            v += count - 1;
+            pos = v + 1;
+        }
+        delta_bytes += out.back().size();
+        // Even an unchanged frame sends one empty delta: the next delta needs it as its base.
+        // The receiver stores a delta's payloads in a frame buffer, so they must fit in one.
+        const size_t fragments = (bytes + K_STREAM_MAX_PAYLOAD - 1) / K_STREAM_MAX_PAYLOAD;
+        if (delta_bytes >= bytes + fragments * K_STREAM_HEADER_BYTES ||
+            delta_bytes - out.size() * K_STREAM_HEADER_BYTES > bytes)
+            key = true;
+    }
+    if (key) {
+        out.clear();
+        for (size_t off = 0; off < bytes; off += K_STREAM_MAX_PAYLOAD) {
+            const size_t n = bytes - off < K_STREAM_MAX_PAYLOAD ? bytes - off : K_STREAM_MAX_PAYLOAD;
+            out.push_back(start_datagram(StreamFrameType::Raw, seq_, pts_us, (uint32_t)off));
+            out.back().insert(out.back().end(), cur + off, cur + off + n);
+        }
+    }
+    for (size_t i = 0; i < out.size(); ++i) {
+        out[i][6] = (uint8_t)i;
+        out[i][7] = (uint8_t)out.size();
+    }
+
+    prev_.copy_from(frame);
+    ++seq_;
+    return out;
+}
+
+} // namespace stream
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "stream.hpp"
+#include <stdint.h>
+#include <vector>
+
+// Host-side encoder for the stream protocol described in stream.hpp: turns frames into the
+// datagrams a StreamReceiver expects.
+namespace stream {
+
+class StreamSender {
+  public:
+    // Every `key_interval` frames is sent Raw (0 = only the first); the others are sent as
+    // deltas unless that would take more bytes
+    StreamSender(uint32_t width, uint32_t height, uint32_t depth, uint32_t key_interval = K_STREAM_KEY_INTERVAL)
+        : prev_(width, height, depth), key_interval_(key_interval) {}
+
+    // The datagrams of the next frame, shown at `pts_us` on the sender's clock
+    std::vector<std::vector<uint8_t>> encode(const Frame &frame, uint32_t pts_us);
+    uint32_t sequence() const { return seq_; }
+
+  private:
+    Frame prev_;
+    uint32_t key_interval_;
+    uint32_t seq_ = 0;
+};
+
+} // namespace stream
@@ -0,0 +1,17 @@
+#pragma once
+// Host stand-in for the CPU cycle counter: the TSC on x86, nanoseconds elsewhere.
+#include <stdint.h>
+
+typedef uint32_t esp_cpu_cycle_count_t;
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void) { return (esp_cpu_cycle_count_t)__rdtsc(); }
+#else
+#include <time.h>
+static inline esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (esp_cpu_cycle_count_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+#endif
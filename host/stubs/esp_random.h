@@ -0,0 +1,18 @@
+#pragma once
+// Host stand-in for the hardware RNG: a seeded xorshift so simulator runs are reproducible.
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t esp_random(void);
+void esp_fill_random(void *buf, size_t len);
+
+// Host only: restart the sequence from `seed` (non-zero)
+void host_seed_random(uint32_t seed);
+
+#ifdef __cplusplus
+}
+#endif
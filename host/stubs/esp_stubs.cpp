@@ -0,0 +1,64 @@
+// Host implementations of the ESP-IDF / FreeRTOS functions declared in stubs/
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "freertos/task.h"
+#include <string.h>
+#include <time.h>
+
+static uint32_t s_rng_state = 0x12345678u;
+
+extern "C" void host_seed_random(uint32_t seed) { s_rng_state = seed ? seed : 0x12345678u; }
+
+extern "C" uint32_t esp_random(void) {
+    // xorshift32
+    uint32_t x = s_rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    s_rng_state = x;
+    return x;
+}
+
+extern "C" void esp_fill_random(void *buf, size_t len) {
+    uint8_t *p = static_cast<uint8_t *>(buf);
+    while (len >= 4) {
+        const uint32_t r = esp_random();
+        memcpy(p, &r, 4);
+        p += 4;
+        len -= 4;
+    }
+    if (len) {
+        const uint32_t r = esp_random();
+        memcpy(p, &r, len);
+    }
+}
+
+static int64_t monotonic_us() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+extern "C" int64_t esp_timer_get_time(void) {
+    static const int64_t s_boot_us = monotonic_us();
+    return monotonic_us() - s_boot_us;
+}
+
+extern "C" TickType_t xTaskGetTickCount(void) {
+    return static_cast<TickType_t>(esp_timer_get_time() / (1000 * portTICK_PERIOD_MS));
+}
+
+extern "C" void vTaskDelay(TickType_t ticks) {
+    const int64_t us = static_cast<int64_t>(ticks) * portTICK_PERIOD_MS * 1000;
+    timespec ts{static_cast<time_t>(us / 1000000), static_cast<long>((us % 1000000) * 1000)};
+    nanosleep(&ts, nullptr);
+}
+
+extern "C" BaseType_t xTaskDelayUntil(TickType_t *prev_wake, TickType_t increment) {
+    const TickType_t target = *prev_wake + increment;
+    const TickType_t now = xTaskGetTickCount();
+    *prev_wake = target;
+    if (static_cast<int32_t>(target - now) <= 0) return pdFALSE;
+    vTaskDelay(target - now);
+    return pdTRUE;
+}
@@ -0,0 +1,14 @@
+#pragma once
+// Host stand-in for esp_timer: microseconds since the first call, from the monotonic clock.
+#include "esp_err.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int64_t esp_timer_get_time(void);
+
+#ifdef __cplusplus
+}
+#endif
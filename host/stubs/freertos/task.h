@@ -0,0 +1,15 @@
+#pragma once
+// Host stand-in for the FreeRTOS delay API: delays sleep the calling thread.
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount(void);
+BaseType_t xTaskDelayUntil(TickType_t *prev_wake, TickType_t increment);
+
+#ifdef __cplusplus
+}
+#endif
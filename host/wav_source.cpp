@@ -0,0 +1,77 @@
+#include "wav_source.hpp"
+#include <string.h>
+
+static uint32_t rd32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+static uint16_t rd16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+
+WavSource::~WavSource() {
+    if (file_) fclose(file_);
+}
+
+bool WavSource::open(const char *path) {
+    file_ = fopen(path, "rb");
+    if (!file_) {
+        perror(path);
+        return false;
+    }
+    uint8_t riff[12];
+    if (fread(riff, 1, 12, file_) != 12 || memcmp(riff, "RIFF", 4) != 0 || memcmp(riff + 8, "WAVE", 4) != 0) {
+        fprintf(stderr, "%s: not a RIFF/WAVE file\n", path);
+        return false;
+    }
+
+    // Walk the chunks up to "data", picking up the format on the way
+    uint8_t chunk[8];
+    while (fread(chunk, 1, 8, file_) == 8) {
+        const uint32_t size = rd32(chunk + 4);
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            uint8_t fmt[16];
+            if (size < 16 || fread(fmt, 1, 16, file_) != 16) break;
+            const uint16_t format = rd16(fmt);
+            channels_ = rd16(fmt + 2);
+            rate_ = rd32(fmt + 4);
+            bytes_per_sample_ = (uint16_t)(rd16(fmt + 14) / 8);
+            // 0xFFFE is WAVE_FORMAT_EXTENSIBLE, which we take to be integer PCM as well
+            if ((format != 1 && format != 0xFFFE) || channels_ == 0 || rate_ == 0 || bytes_per_sample_ == 0 ||
+                bytes_per_sample_ > 4) {
+                fprintf(stderr, "%s: only integer PCM is supported\n", path);
+                return false;
+            }
+            fseek(file_, (long)(size - 16 + (size & 1)), SEEK_CUR);
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            if (rate_ == 0) break;
+            remaining_ = size;
+            return true;
+        } else {
+            fseek(file_, (long)(size + (size & 1)), SEEK_CUR); // chunks are padded to even sizes
+        }
+    }
+    fprintf(stderr, "%s: no format or data chunk\n", path);
+    return false;
+}
+
+size_t WavSource::read(int16_t *dst, size_t n) {
+    const size_t frame_bytes = (size_t)channels_ * bytes_per_sample_;
+    if (!file_ || frame_bytes == 0) return 0;
+    size_t frames = remaining_ / frame_bytes;
+    if (frames > n) frames = n;
+    raw_.resize(frames * frame_bytes);
+    frames = fread(raw_.data(), frame_bytes, frames, file_);
+    remaining_ -= (uint32_t)(frames * frame_bytes);
+
+    const uint8_t *p = raw_.data();
+    for (size_t i = 0; i < frames; ++i) {
+        int32_t sum = 0;
+        for (uint16_t c = 0; c < channels_; ++c, p += bytes_per_sample_) {
+            // The top 16 bits of each sample; 8-bit WAV is unsigned
+            if (bytes_per_sample_ == 1)
+                sum += ((int32_t)p[0] - 128) << 8;
+            else
+                sum += (int16_t)(p[bytes_per_sample_ - 2] | (p[bytes_per_sample_ - 1] << 8));
+        }
+        dst[i] = (int16_t)(sum / channels_);
+    }
+    return frames;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "audio.hpp"
+#include <stdio.h>
+#include <vector>
+
+// Host-side audio::SampleSource reading a PCM WAV file (8, 16, 24 or 32-bit integer, any
+// channel count, mixed down to mono). Reads never block: the caller paces them.
+class WavSource : public audio::SampleSource {
+  public:
+    ~WavSource();
+
+    // Open `path` and check its format; false with a message on stderr if it cannot be played
+    bool open(const char *path);
+
+    uint32_t sample_rate() const override { return rate_; }
+    size_t read(int16_t *dst, size_t n) override;
+
+  private:
+    FILE *file_ = nullptr;
+    uint32_t rate_ = 0;
+    uint16_t channels_ = 0;
+    uint16_t bytes_per_sample_ = 0;
+    uint32_t remaining_ = 0; // bytes of sample data left
+    std::vector<uint8_t> raw_;
+};
@@ -1,15 +1,35 @@
-#include "button.hpp"
+#include "audio_anim.hpp"
+#include "bench.hpp"
 #include "circle.hpp"
+#include "clip_partition.hpp"
+#include "compositor.hpp"
 #include "countdown.hpp"
 #include "cube.hpp"
+#include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "i2s_source.hpp"
+#include "input.hpp"
+#include "noise_anim.hpp"
 #include "rain.hpp"
+#include "render.hpp"
+#include "scroll_text.hpp"
+#include "stream.hpp"
 
 using namespace cube;
 using namespace rain_animation;
 using namespace countdown_animation;
 using namespace circle_animation;
+using namespace scroll_text_animation;
+using namespace audio_animation;
+using namespace noise_animation;
+using render::RenderScheduler;
+
+// Set to 1 to benchmark every animation on the real strips at boot, before normal playback
+#define AURORA_RUN_BENCHMARK 0
+// Set to 1 to add the "stream" animation, which plays frames sent over UDP (see README).
+// Bringing up Wi-Fi or Ethernet first is left to the application.
+#define AURORA_ENABLE_STREAM 0
 
 extern "C" void app_main(void) {
     // Global brightness configuration (0–100%)
@@ -24,8 +44,8 @@ extern "C" void app_main(void) {
     CubeCreateArgs args{.backend = Backend::RMT,
                         .chains = chains,
                         .chain_count = 2,
-                        .panels_width = K_MAX_WIDTH,
-                        .panels_height = K_MAX_HEIGHT};
+                        .panels_width = K_PANEL_WIDTH,
+                        .panels_height = K_PANEL_HEIGHT};
     Cube cube(args);
 
     // Apply global brightness to all subsequent animation output
@@ -34,36 +54,76 @@ extern "C" void app_main(void) {
     ESP_ERROR_CHECK(cube.clear());
     vTaskDelay(pdMS_TO_TICKS(1000));
 
-    // --- init button: GPIO0, pull-up, active-low, falling-edge ---
-    ESP_ERROR_CHECK(button_init(GPIO_NUM_2, /*pull_up=*/true));
-    SemaphoreHandle_t btn_sem = button_get_semaphore();
+#if AURORA_RUN_BENCHMARK
+    bench::run_all(cube);
+#endif
 
     // --- animation states ---
     static LightRainAnim light_rain;
     static HeavyRainAnim heavy_rain;
     static CountdownAnim countdown;
     static CircleSpinAnim circle_spin;
+    static ScrollTextAnim scroll_text;
+    // Noise fields, each evaluated in fixed point a few rows per frame
+    static PlasmaAnim plasma;
+    static FireAnim fire;
+    static CloudsAnim clouds;
+    // Plays whatever clip was flashed to the "clips" partition (dark if there is none)
+    static clip::PartitionClipAnim flash_clip("flash_clip");
+    // Rain falling through the spinning disc; each layer needs its own animation instance
+    static CircleSpinAnim disc_layer;
+    static LightRainAnim rain_layer;
+    const compositor::Layer rain_disc_layers[] = {
+        {&disc_layer, BlendMode::Alpha, 255},
+        {&rain_layer, BlendMode::Add, 255},
+    };
+    static compositor::Compositor rain_disc("rain_disc", rain_disc_layers, 2);
+    // Audio-reactive animations, fed by the audio task below
+    static audio::Feed audio_feed;
+    static SpectrumAnim spectrum(audio_feed);
+    static BeatBurstAnim beat_burst(audio_feed);
+#if AURORA_ENABLE_STREAM
+    // Frames from a PC renderer on UDP port K_STREAM_DEFAULT_PORT
+    static stream::StreamAnim net_stream("stream", cube.width(), cube.height(), cube.depth());
+#endif
 
-    IAnimation *animations[] = {
-        &light_rain, &heavy_rain, &countdown, &circle_spin,
-        // later: add &plane_sweep, &plasma, ...
+    static IAnimation *animations[] = {
+        &light_rain, &heavy_rain, &countdown, &circle_spin, &scroll_text,
+        &rain_disc, &flash_clip, &spectrum, &beat_burst, &plasma, &fire, &clouds,
+#if AURORA_ENABLE_STREAM
+        &net_stream,
+#endif
+        // later: add &plane_sweep, ...
     };
     constexpr int ANIM_COUNT = sizeof(animations) / sizeof(animations[0]);
 
-    // -------- Init animations ---------
-    int current_index = 0;
-    IAnimation *current = animations[current_index];
-    current->init(cube);
+    // --- I2S MEMS microphone (SCK GPIO19, WS GPIO20, SD GPIO21, L/R to GND) ---
+    // Without a microphone the audio animations simply stay dark, so a failure is not fatal.
+    static audio::I2sSource mic;
+    esp_err_t err = mic.init(audio::I2sMicConfig{.bclk = GPIO_NUM_19, .ws = GPIO_NUM_20, .din = GPIO_NUM_21});
+    if (err == ESP_OK) err = audio::start(mic, audio_feed);
+    if (err != ESP_OK) ESP_LOGW("main", "audio input unavailable: %s", esp_err_to_name(err));
 
-    while (true) {
-        // 1) Run one frame of the current animation
-        current->step(cube);
+    // -------- Render task: paces step()/show() on its own deadlines ---------
+    static RenderScheduler scheduler(cube, animations, ANIM_COUNT);
+    ESP_ERROR_CHECK(scheduler.start());
 
-        // 2) Non-blocking check for button press
-        if (xSemaphoreTake(btn_sem, 0) == pdTRUE) {
-            current_index = (current_index + 1) % ANIM_COUNT;
-            current = animations[current_index];
-            current->init(cube);
-        }
+    // --- Button on GPIO2, active-low with the internal pull-up ---
+    // A click switches to the next animation from the input task, waking the render task;
+    // holding the button goes back to the first animation. Press would also fire at the start
+    // of every long press, so a hold would skip one animation before going back to the first.
+    // Without double-click detection the click fires on release and quick presses all count.
+    const input::ButtonConfig buttons[] = {{GPIO_NUM_2, true, false}};
+    ESP_ERROR_CHECK(input::init(
+        buttons, 1,
+        [](const input::Event &e, void *ctx) {
+            auto *s = static_cast<RenderScheduler *>(ctx);
+            if (e.type == input::EventType::Click) s->next();
+            if (e.type == input::EventType::LongPress) s->select(0);
+        },
+        &scheduler));
+
+    while (true) {
+        vTaskDelay(portMAX_DELAY);
     }
 }